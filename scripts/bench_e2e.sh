@@ -0,0 +1,281 @@
+#!/bin/bash
+# =================================================================
+# bench_e2e.sh - End-to-End Throughput Benchmark for Teradata Export
+# =================================================================
+#
+# Companion to test_e2e.sh: where that script verifies one small export
+# is correct, this one measures sustained throughput across table
+# shapes and compression modes and compares the numbers against a
+# recorded baseline, so release qualification no longer means
+# hand-timing a 100GB export.
+#
+# For each (mix, rows, codec) cell it:
+#   1. generates a benchmark table of the requested shape and size
+#      (doubling INSERT..SELECT, so population is log2(rows) statements)
+#   2. runs the Table Operator with that codec via the same DIMENSION
+#      clause the connector builds in TrinoExportDynamicFilteringSplitSource
+#   3. parses the per-AMP stats rows (rows_processed, bytes_sent,
+#      batches_sent) out of the bteq output and records wall-clock,
+#      aggregate MB/s and per-AMP MB/s into a CSV
+#   4. fails the run if aggregate MB/s regresses more than
+#      BENCH_THRESHOLD_PCT below the baseline for that cell
+#
+# The export needs a data sink: point BRIDGE_HOST:BRIDGE_PORT at a
+# running bridge (a Trino worker with the connector, or any listener
+# that speaks the handshake). Rows land in DataBufferRegistry and are
+# dropped there when no PageSource claims the query id, which is
+# exactly what we want for a sender-side throughput number.
+#
+# Usage:
+#   scripts/bench_e2e.sh                  run against the baseline
+#   scripts/bench_e2e.sh --update-baseline  record current numbers
+#
+set -e
+set -o pipefail
+
+# Colors
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+NC='\033[0m'
+
+PROJECT_DIR=$(dirname "$(dirname "$(readlink -f "$0")")")
+
+# Configuration
+TD_HOST="${TD_HOST:-192.168.137.129}"
+TD_USER="${TD_USER:-dbc}"
+TD_PASS="${TD_PASS:-dbc}"
+BRIDGE_HOST="${BRIDGE_HOST:-127.0.0.1}"
+BRIDGE_PORT="${BRIDGE_PORT:-50052}"
+BENCH_DB="${BENCH_DB:-TrinoExport}"
+
+# Benchmark matrix. Codecs are the set parse_params_from_stream()
+# accepts; COLUMNAR rides along as a format suffix on each codec run
+# when BENCH_COLUMNAR=1.
+BENCH_ROWS="${BENCH_ROWS:-100000 1000000}"
+BENCH_MIXES="${BENCH_MIXES:-numeric varchar decimal unicode}"
+BENCH_CODECS="${BENCH_CODECS:-NONE ZLIB LZ4 LZ4S ZSTD ADAPTIVE}"
+BENCH_COLUMNAR="${BENCH_COLUMNAR:-0}"
+BENCH_BATCH_SIZE="${BENCH_BATCH_SIZE:-10000}"
+
+# Regression gate
+BASELINE_FILE="${BASELINE_FILE:-$PROJECT_DIR/tests/bench_e2e_baseline.csv}"
+RESULTS_FILE="${RESULTS_FILE:-$PROJECT_DIR/tests/bench_e2e_results.csv}"
+BENCH_THRESHOLD_PCT="${BENCH_THRESHOLD_PCT:-10}"
+
+export TD_HOME="${TD_HOME:-/opt/teradata/client/20.00}"
+export PATH=$PATH:$TD_HOME/bin
+export LD_LIBRARY_PATH=$LD_LIBRARY_PATH:$TD_HOME/lib64:$TD_HOME/lib
+
+UPDATE_BASELINE=0
+if [ "$1" = "--update-baseline" ]; then
+    UPDATE_BASELINE=1
+fi
+
+echo -e "${BLUE}╔═══════════════════════════════════════════════════════════╗${NC}"
+echo -e "${BLUE}║      Teradata to Trino - E2E Throughput Benchmark         ║${NC}"
+echo -e "${BLUE}╚═══════════════════════════════════════════════════════════╝${NC}"
+echo ""
+echo "  Rows:    $BENCH_ROWS"
+echo "  Mixes:   $BENCH_MIXES"
+echo "  Codecs:  $BENCH_CODECS"
+echo "  Bridge:  $BRIDGE_HOST:$BRIDGE_PORT"
+echo "  Baseline: $BASELINE_FILE (threshold ${BENCH_THRESHOLD_PCT}%)"
+echo ""
+
+run_bteq() {
+    bteq 2>&1 << EOF
+.LOGON $TD_HOST/$TD_USER,$TD_PASS
+DATABASE $BENCH_DB;
+$1
+.QUIT
+EOF
+}
+
+# ---------------------------------------------------------------
+# Column lists per mix. Widths are chosen so each mix stresses a
+# different serializer path: numeric hits the fixed-width fast path,
+# varchar the length-prefixed path, decimal the DECIMAL width ladder,
+# unicode the UTF-16 -> UTF-8 transcoder.
+# ---------------------------------------------------------------
+mix_ddl() {
+    case "$1" in
+        numeric)
+            echo "id_col INTEGER, small_col SMALLINT, big_col BIGINT, float_col FLOAT, date_col DATE" ;;
+        varchar)
+            echo "id_col INTEGER, name_col VARCHAR(100), descr_col VARCHAR(400), tag_col VARCHAR(20)" ;;
+        decimal)
+            echo "id_col INTEGER, amt1 DECIMAL(5,2), amt2 DECIMAL(12,4), amt3 DECIMAL(18,6), amt4 DECIMAL(38,10)" ;;
+        unicode)
+            echo "id_col INTEGER, uname VARCHAR(100) CHARACTER SET UNICODE, unote VARCHAR(400) CHARACTER SET UNICODE" ;;
+    esac
+}
+
+mix_seed_values() {
+    case "$1" in
+        numeric)
+            echo "(1, 7, 123456789012, 3.14159, DATE '2024-01-15')" ;;
+        varchar)
+            echo "(1, 'benchmark row', 'a moderately long description value that compresses like typical text does', 'tag')" ;;
+        decimal)
+            echo "(1, 123.45, 12345678.9012, 123456789012.345678, 1234567890123456789012345678.9012345678)" ;;
+        unicode)
+            echo "(1, 'bench üñîçøđé', 'mixed ascii and accented text àèìòù so both utf8 paths run')" ;;
+    esac
+}
+
+# Populate by doubling: seed one row, then INSERT..SELECT until the
+# table holds at least the requested count. id_col is re-derived so
+# values stay distinct and zone maps / predicates see a real range.
+make_bench_table() {
+    local mix=$1 rows=$2 table=$3
+    local ddl seed count=1 stmts="" cols
+    ddl=$(mix_ddl "$mix")
+    seed=$(mix_seed_values "$mix")
+    stmts="DROP TABLE $table;
+CREATE TABLE $table ($ddl);
+INSERT INTO $table VALUES $seed;"
+    case "$mix" in
+        numeric) cols="small_col, big_col, float_col, date_col" ;;
+        varchar) cols="name_col, descr_col, tag_col" ;;
+        decimal) cols="amt1, amt2, amt3, amt4" ;;
+        unicode) cols="uname, unote" ;;
+    esac
+    while [ "$count" -lt "$rows" ]; do
+        stmts="$stmts
+INSERT INTO $table SELECT id_col + $count, $cols FROM $table;"
+        count=$((count * 2))
+    done
+    local out
+    out=$(run_bteq "$stmts")
+    if echo "$out" | grep -q "Failure"; then
+        # DROP of a missing table is the only failure we tolerate
+        if echo "$out" | grep "Failure" | grep -qv "3807"; then
+            echo -e "${RED}✗ Failed to build $table${NC}" >&2
+            echo "$out" >&2
+            return 1
+        fi
+    fi
+    return 0
+}
+
+# ---------------------------------------------------------------
+# One benchmark cell: run the export, parse per-AMP stats, append a
+# CSV row, gate against the baseline.
+# ---------------------------------------------------------------
+FAILURES=0
+run_cell() {
+    local mix=$1 rows=$2 codec=$3 table=$4
+    local options="$codec"
+    [ "$BENCH_COLUMNAR" = "1" ] && options="$options,COLUMNAR"
+    local qid="bench-$mix-$rows-$codec-$$"
+
+    local sql="SELECT * FROM ExportToTrino(
+    ON (SELECT * FROM $table)
+    ON (SELECT CAST('$BRIDGE_HOST:$BRIDGE_PORT' AS VARCHAR(2048)) as target_ips,
+               CAST('$qid' AS VARCHAR(256)) as qid,
+               CAST('bench-token' AS VARCHAR(256)) as token,
+               CAST($BENCH_BATCH_SIZE AS INTEGER) as batch_size,
+               CAST('$options' AS VARCHAR(20)) as compression_algorithm) DIMENSION
+) AS export_result;"
+
+    local t0 t1 out
+    t0=$(date +%s.%N)
+    out=$(run_bteq "$sql")
+    t1=$(date +%s.%N)
+
+    if ! echo "$out" | grep -q "SUCCESS"; then
+        echo -e "${RED}✗ $mix/$rows/$codec export failed${NC}"
+        echo "$out" | grep -E "ERROR|Failure" | head -5
+        FAILURES=$((FAILURES + 1))
+        return 0
+    fi
+
+    # Per-AMP stats row: amp_id rows_processed bytes_sent null_count
+    # batches_sent column_count status. bteq prints them space-separated
+    # in column order, status last.
+    local wall amps total_rows total_bytes total_batches mbps amp_mbps
+    wall=$(echo "$t1 $t0" | awk '{printf "%.2f", $1 - $2}')
+    amps=$(echo "$out" | grep -c "SUCCESS")
+    total_rows=$(echo "$out" | grep "SUCCESS" | awk '{sum += $2} END {print sum + 0}')
+    total_bytes=$(echo "$out" | grep "SUCCESS" | awk '{sum += $3} END {print sum + 0}')
+    total_batches=$(echo "$out" | grep "SUCCESS" | awk '{sum += $5} END {print sum + 0}')
+    mbps=$(echo "$total_bytes $wall" | awk '{printf "%.2f", $1 / $2 / 1048576}')
+    amp_mbps=$(echo "$mbps $amps" | awk '{printf "%.2f", $1 / $2}')
+
+    printf "  %-8s %9s rows  %-8s  %6ss  %8s MB/s (%s MB/s/AMP, %s AMPs, %s batches)\n" \
+        "$mix" "$total_rows" "$codec" "$wall" "$mbps" "$amp_mbps" "$amps" "$total_batches"
+
+    echo "$(date -u +%Y-%m-%dT%H:%M:%SZ),$mix,$rows,$codec,$BENCH_COLUMNAR,$amps,$total_rows,$total_bytes,$total_batches,$wall,$mbps,$amp_mbps" >> "$RESULTS_FILE"
+
+    if [ "$UPDATE_BASELINE" = "0" ] && [ -f "$BASELINE_FILE" ]; then
+        local base
+        base=$(awk -F, -v m="$mix" -v r="$rows" -v c="$codec" -v f="$BENCH_COLUMNAR" \
+            '$2 == m && $3 == r && $4 == c && $5 == f { print $11 }' "$BASELINE_FILE" | tail -1)
+        if [ -n "$base" ]; then
+            local ok
+            ok=$(echo "$mbps $base $BENCH_THRESHOLD_PCT" | awk '{ print ($1 >= $2 * (1 - $3 / 100)) ? 1 : 0 }')
+            if [ "$ok" = "0" ]; then
+                echo -e "    ${RED}✗ REGRESSION: $mbps MB/s vs baseline $base MB/s (threshold ${BENCH_THRESHOLD_PCT}%)${NC}"
+                FAILURES=$((FAILURES + 1))
+            fi
+        else
+            echo -e "    ${YELLOW}⚠ no baseline for $mix/$rows/$codec — run with --update-baseline${NC}"
+        fi
+    fi
+    return 0
+}
+
+# =============================================
+# Preflight: connection + registration, as in test_e2e.sh
+# =============================================
+echo -e "${YELLOW}[Preflight] Verifying Teradata connection and registration...${NC}"
+PRE=$(run_bteq "SELECT COUNT(*) FROM DBC.FunctionsV WHERE FunctionName = 'EXPORTTOTRINO';")
+if ! echo "$PRE" | grep -q "Query completed"; then
+    echo -e "${RED}✗ Teradata connection failed${NC}"
+    echo "$PRE"
+    exit 1
+fi
+if ! echo "$PRE" | grep -q "1"; then
+    echo -e "${RED}✗ ExportToTrino is not registered — run: bteq < scripts/register.bteq${NC}"
+    exit 1
+fi
+echo -e "${GREEN}✓ Connection and registration OK${NC}"
+echo ""
+
+mkdir -p "$(dirname "$RESULTS_FILE")"
+echo "timestamp,mix,rows,codec,columnar,amps,rows_processed,bytes_sent,batches_sent,wall_s,mbps,mbps_per_amp" > "$RESULTS_FILE"
+
+# =============================================
+# The matrix
+# =============================================
+for mix in $BENCH_MIXES; do
+    for rows in $BENCH_ROWS; do
+        table="BenchE2E_${mix}_${rows}"
+        echo -e "${YELLOW}[Setup] $table (${mix}, ${rows} rows)...${NC}"
+        make_bench_table "$mix" "$rows" "$table" || { FAILURES=$((FAILURES + 1)); continue; }
+        for codec in $BENCH_CODECS; do
+            run_cell "$mix" "$rows" "$codec" "$table"
+        done
+        run_bteq "DROP TABLE $table;" > /dev/null
+    done
+done
+
+# =============================================
+# Summary / baseline update
+# =============================================
+echo ""
+echo -e "${BLUE}═══════════════════════════════════════════════════════════${NC}"
+if [ "$UPDATE_BASELINE" = "1" ]; then
+    cp "$RESULTS_FILE" "$BASELINE_FILE"
+    echo -e "${GREEN}Baseline updated: $BASELINE_FILE${NC}"
+    exit 0
+fi
+if [ "$FAILURES" -gt 0 ]; then
+    echo -e "${RED}Benchmark FAILED: $FAILURES cell(s) errored or regressed${NC}"
+    echo "Results: $RESULTS_FILE"
+    exit 1
+fi
+echo -e "${GREEN}Benchmark complete, no regressions.${NC}"
+echo "Results: $RESULTS_FILE"
@@ -5,41 +5,127 @@
 
 namespace td_export {
 
+/**
+ * Arrow MemoryPool backed by FNC allocation, with two layers of reuse so
+ * builder buffer growth does not round-trip through FNC_malloc:
+ *
+ *  - A bump arena of 4MB slabs. Small/medium blocks are carved off the
+ *    current slab with a pointer bump; slabs persist for the life of the
+ *    pool and are re-bumped from the start after ResetBatch().
+ *  - Power-of-two size-class freelists. Free() of an arena-class block
+ *    pushes it on its class list, and Allocate() pops there first, so the
+ *    repeated grow-copy-free cycle of Arrow builders recycles the same
+ *    few blocks instead of allocating fresh ones.
+ *
+ * Blocks above the largest size class (1MB) go straight to FNC_malloc and
+ * back to FNC_free; batch payload buffers of that size are rare compared
+ * to builder growth steps.
+ *
+ * ResetBatch() invalidates every arena block at once. The export loop may
+ * only call it between batches, after the RecordBatch, its arrays, and the
+ * builders that produced them have all been dropped.
+ *
+ * Not thread-safe (beyond the bytes_allocated_ counter): a Table Operator
+ * instance is single-threaded, matching the rest of the export path.
+ */
 class TeradataMemoryPool : public arrow::MemoryPool {
 public:
-    TeradataMemoryPool() : bytes_allocated_(0) {}
-    ~TeradataMemoryPool() override {}
+    TeradataMemoryPool() : bytes_allocated_(0), slabs_(nullptr), current_(nullptr) {
+        for (int i = 0; i < kNumClasses; ++i) {
+            freelists_[i] = nullptr;
+        }
+    }
+
+    ~TeradataMemoryPool() override {
+        Slab* s = slabs_;
+        while (s != nullptr) {
+            Slab* next = s->next;
+            FNC_free(s);
+            s = next;
+        }
+    }
 
     arrow::Status Allocate(int64_t size, uint8_t** out) override {
-        *out = static_cast<uint8_t*>(FNC_malloc(size));
-        if (*out == nullptr) {
-            return arrow::Status::OutOfMemory("FNC_malloc failed");
+        if (size <= 0) {
+            *out = reinterpret_cast<uint8_t*>(&zero_size_area_);
+            return arrow::Status::OK();
+        }
+        int cls = SizeClass(size);
+        if (cls < 0) {
+            *out = static_cast<uint8_t*>(FNC_malloc(size));
+            if (*out == nullptr) {
+                return arrow::Status::OutOfMemory("FNC_malloc failed");
+            }
+            bytes_allocated_ += size;
+            return arrow::Status::OK();
+        }
+        if (freelists_[cls] != nullptr) {
+            FreeBlock* block = freelists_[cls];
+            freelists_[cls] = block->next;
+            *out = reinterpret_cast<uint8_t*>(block);
+            bytes_allocated_ += size;
+            return arrow::Status::OK();
         }
+        uint8_t* p = BumpAlloc(kMinClassSize << cls);
+        if (p == nullptr) {
+            return arrow::Status::OutOfMemory("FNC_malloc failed for arena slab");
+        }
+        *out = p;
         bytes_allocated_ += size;
         return arrow::Status::OK();
     }
 
     arrow::Status Reallocate(int64_t old_size, int64_t new_size, uint8_t** ptr) override {
-        // Teradata FNC_malloc doesn't have a direct realloc.
-        // We'll mimic it with malloc + memcpy + free.
-        uint8_t* new_ptr = static_cast<uint8_t*>(FNC_malloc(new_size));
-        if (new_ptr == nullptr) {
-            return arrow::Status::OutOfMemory("FNC_malloc failed during reallocate");
+        // Same size class: the block is already big enough, keep it in place.
+        // This is the common case for Arrow's doubling growth inside a class.
+        // Zero-size buffers point at the shared zero_size_area_, not a class
+        // block, so they must always take the fresh-Allocate path below.
+        if (old_size > 0 && new_size > 0) {
+            int old_cls = SizeClass(old_size);
+            if (old_cls >= 0 && old_cls == SizeClass(new_size)) {
+                bytes_allocated_ += new_size - old_size;
+                return arrow::Status::OK();
+            }
         }
-        if (*ptr != nullptr) {
+        uint8_t* new_ptr;
+        ARROW_RETURN_NOT_OK(Allocate(new_size, &new_ptr));
+        if (*ptr != nullptr && old_size > 0) {
             memcpy(new_ptr, *ptr, std::min(old_size, new_size));
-            FNC_free(*ptr);
+            Free(*ptr, old_size);
         }
         *ptr = new_ptr;
-        bytes_allocated_ += (new_size - old_size);
         return arrow::Status::OK();
     }
 
     void Free(uint8_t* buffer, int64_t size) override {
-        if (buffer != nullptr) {
+        if (buffer == nullptr || size <= 0) {
+            return;
+        }
+        int cls = SizeClass(size);
+        if (cls < 0) {
             FNC_free(buffer);
-            bytes_allocated_ -= size;
+        } else {
+            // Arena block: recycle through its size-class freelist
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(buffer);
+            block->next = freelists_[cls];
+            freelists_[cls] = block;
         }
+        bytes_allocated_ -= size;
+    }
+
+    /**
+     * Drop every arena block at once and rewind the slabs for the next
+     * batch. Freelists are cleared too - their blocks live in the slabs.
+     * All arena allocations made since the last reset become invalid.
+     */
+    void ResetBatch() {
+        for (int i = 0; i < kNumClasses; ++i) {
+            freelists_[i] = nullptr;
+        }
+        for (Slab* s = slabs_; s != nullptr; s = s->next) {
+            s->used = 0;
+        }
+        current_ = slabs_;
     }
 
     int64_t bytes_allocated() const override {
@@ -56,7 +142,78 @@ public:
     }
 
 private:
+    static constexpr int64_t kMinClassSize = 64;
+    static constexpr int kNumClasses = 15;           /* 64B .. 1MB */
+    static constexpr int64_t kSlabSize = 4 * 1024 * 1024;
+    static constexpr int64_t kAlignment = 64;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct Slab {
+        Slab* next;
+        int64_t used;
+        /* slab data follows the header */
+    };
+
+    /* Index of the smallest class holding `size` bytes, or -1 if the block
+     * is too large for the arena and should go to FNC_malloc directly */
+    static int SizeClass(int64_t size) {
+        int64_t cls_size = kMinClassSize;
+        for (int i = 0; i < kNumClasses; ++i) {
+            if (size <= cls_size) {
+                return i;
+            }
+            cls_size <<= 1;
+        }
+        return -1;
+    }
+
+    static uint8_t* SlabData(Slab* s) {
+        return reinterpret_cast<uint8_t*>(s) + AlignUp(sizeof(Slab));
+    }
+
+    static int64_t AlignUp(int64_t v) {
+        return (v + kAlignment - 1) & ~(kAlignment - 1);
+    }
+
+    uint8_t* BumpAlloc(int64_t size) {
+        /* Walk from the current slab; earlier slabs are full by invariant */
+        for (Slab* s = current_; s != nullptr; s = s->next) {
+            int64_t capacity = kSlabSize - AlignUp(sizeof(Slab));
+            if (s->used + size <= capacity) {
+                uint8_t* p = SlabData(s) + s->used;
+                s->used = AlignUp(s->used + size);
+                current_ = s;
+                return p;
+            }
+        }
+        Slab* slab = static_cast<Slab*>(FNC_malloc(kSlabSize));
+        if (slab == nullptr) {
+            return nullptr;
+        }
+        slab->used = AlignUp(size);
+        /* Append so ResetBatch rewinds slabs in a stable order */
+        slab->next = nullptr;
+        if (slabs_ == nullptr) {
+            slabs_ = slab;
+        } else {
+            Slab* tail = slabs_;
+            while (tail->next != nullptr) {
+                tail = tail->next;
+            }
+            tail->next = slab;
+        }
+        current_ = slab;
+        return SlabData(slab);
+    }
+
     std::atomic<int64_t> bytes_allocated_;
+    FreeBlock* freelists_[kNumClasses];
+    Slab* slabs_;
+    Slab* current_;
+    uint64_t zero_size_area_ = 0;
 };
 
 } // namespace td_export
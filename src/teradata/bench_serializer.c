@@ -0,0 +1,293 @@
+/*
+ * bench_serializer - offline micro-benchmark for the export hot path.
+ *
+ * Links the UDF translation unit against the mock FNC layer in include/
+ * (no Teradata node or bridge required) and replays synthetic row streams
+ * of a chosen type mix through the same per-column serializer dispatch,
+ * columnar staging and send_batch_to_bridge() calls ExportToTrino() uses,
+ * writing frames into a socketpair drained by a background thread. The
+ * numbers it prints (rows/s, payload MB/s before compression) are the
+ * regression metric for hot-path changes, and sweeping -c/-a/-z is how we
+ * pick codec settings for a given workload shape.
+ *
+ *   bench_serializer [-r rows] [-b batch_rows] [-c codec] [-a lz4_accel]
+ *                    [-z zstd_level] [-m mix]
+ *
+ * codecs: none zlib lz4 lz4s zstd adaptive; mixes: int bigint decimal
+ * varchar mixed all (default all).
+ */
+#include "export_to_trino.c"
+
+#include <unistd.h>
+#include <sys/socket.h>
+
+#define BENCH_ROW_POOL 1024   /* distinct pregenerated rows, cycled */
+#define BENCH_MAX_COLS 16
+#define BENCH_VAL_STRIDE 64   /* bytes reserved per value in the pool */
+
+typedef struct {
+    const char *name;
+    int ncols;
+    int datatypes[BENCH_MAX_COLS];
+    int bytesizes[BENCH_MAX_COLS];
+} BenchMix_t;
+
+static const BenchMix_t bench_mixes[] = {
+    { "int",     8, { INTEGER_DT, INTEGER_DT, INTEGER_DT, INTEGER_DT,
+                      INTEGER_DT, INTEGER_DT, INTEGER_DT, INTEGER_DT },
+                    { 4, 4, 4, 4, 4, 4, 4, 4 } },
+    { "bigint",  8, { BIGINT_DT, BIGINT_DT, BIGINT_DT, BIGINT_DT,
+                      BIGINT_DT, BIGINT_DT, BIGINT_DT, BIGINT_DT },
+                    { 8, 8, 8, 8, 8, 8, 8, 8 } },
+    { "decimal", 6, { DECIMAL4_DT, DECIMAL4_DT, DECIMAL8_DT, DECIMAL8_DT,
+                      DECIMAL16_DT, DECIMAL16_DT },
+                    { 4, 4, 8, 8, 16, 16 } },
+    { "varchar", 4, { VARCHAR_DT, VARCHAR_DT, VARCHAR_DT, VARCHAR_DT },
+                    { 40, 40, 40, 40 } },
+    { "mixed",   6, { INTEGER_DT, BIGINT_DT, DATE_DT, DECIMAL8_DT,
+                      DECIMAL16_DT, VARCHAR_DT },
+                    { 4, 8, 4, 8, 16, 40 } },
+};
+#define BENCH_NUM_MIXES ((int)(sizeof(bench_mixes) / sizeof(bench_mixes[0])))
+
+/* Discard everything the send path writes, like a bridge with an
+ * infinitely fast consumer. */
+static void *bench_drain_main(void *arg) {
+    int fd = *(int *)arg;
+    static char sink[65536];
+    while (read(fd, sink, sizeof(sink)) > 0) { }
+    return NULL;
+}
+
+/* Deterministic value pool: one BENCH_VAL_STRIDE slot per (row, column).
+ * Values vary per row so codecs see realistic (not all-identical) input;
+ * VARCHAR slots carry the Teradata 2-byte-length + latin payload layout
+ * ser_varchar_latin expects, with lengths spread 8..bytesize. */
+static unsigned char *bench_fill_pool(const BenchMix_t *mix) {
+    unsigned char *pool = (unsigned char *)malloc((size_t)BENCH_ROW_POOL * mix->ncols * BENCH_VAL_STRIDE);
+    if (!pool) return NULL;
+    int r, c;
+    for (r = 0; r < BENCH_ROW_POOL; r++) {
+        for (c = 0; c < mix->ncols; c++) {
+            unsigned char *slot = pool + ((size_t)r * mix->ncols + c) * BENCH_VAL_STRIDE;
+            unsigned long long seed = (unsigned long long)(r * 2654435761u) + c * 40503u + 12345u;
+            switch (mix->datatypes[c]) {
+                case INTEGER_DT: { int v = (int)seed; memcpy(slot, &v, 4); break; }
+                case DATE_DT:    { int v = 1250301 + r % 365; memcpy(slot, &v, 4); break; }
+                case BIGINT_DT:  { long long v = (long long)seed * 977; memcpy(slot, &v, 8); break; }
+                case DECIMAL4_DT:  { int v = (int)(seed % 1000000); memcpy(slot, &v, 4); break; }
+                case DECIMAL8_DT:  { long long v = (long long)(seed * 31); memcpy(slot, &v, 8); break; }
+                case DECIMAL16_DT: { long long lo = (long long)seed, hi = (long long)(seed >> 3);
+                                     memcpy(slot, &lo, 8); memcpy(slot + 8, &hi, 8); break; }
+                default: { /* VARCHAR */
+                    short blen = (short)(8 + (int)(seed % (unsigned long long)(mix->bytesizes[c] - 8)));
+                    memcpy(slot, &blen, 2);
+                    int i;
+                    for (i = 0; i < blen; i++) slot[2 + i] = (unsigned char)('a' + (seed + i) % 26);
+                    break;
+                }
+            }
+        }
+    }
+    return pool;
+}
+
+/* Mirror batch_sender_init's codec setup without the sender thread; the
+ * benchmark wants compression and send time on the calling thread. */
+static void bench_ctx_init(SendContext_t *ctx, int sock_fd, int codec, int accel, int zlevel) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->sock_fd = sock_fd;
+    ctx->compression_type = codec;
+    ctx->lz4_accel = (accel > 0) ? accel : 1;
+    ctx->zstd_level = (zlevel > 0) ? zlevel : ZSTD_DEFAULT_LEVEL;
+    ctx->adaptive_codec = COMPRESS_NONE;
+#ifdef HAVE_ZSTD
+    if (codec == COMPRESS_ZSTD) ctx->zstd_cctx = ZSTD_createCCtx();
+#endif
+    if (codec == COMPRESS_LZ4_STREAM) {
+        ctx->lz4s = (Lz4StreamState_t *)FNC_malloc(sizeof(Lz4StreamState_t));
+        if (ctx->lz4s) {
+            memset(ctx->lz4s, 0, sizeof(Lz4StreamState_t));
+            ctx->lz4s->stream = LZ4_createStream();
+        }
+        if (!ctx->lz4s || !ctx->lz4s->stream) ctx->compression_type = COMPRESS_LZ4;
+    }
+}
+
+static void bench_ctx_free(SendContext_t *ctx) {
+#ifdef HAVE_ZSTD
+    if (ctx->zstd_cctx) ZSTD_freeCCtx(ctx->zstd_cctx);
+#endif
+    if (ctx->lz4s) {
+        if (ctx->lz4s->stream) LZ4_freeStream(ctx->lz4s->stream);
+        FNC_free(ctx->lz4s);
+    }
+    if (ctx->dest) FNC_free(ctx->dest);
+    if (ctx->iov) FNC_free(ctx->iov);
+}
+
+static void bench_report(const char *mix, const char *path, long long rows,
+                         long long payload_bytes, long long ns) {
+    double secs = ns / 1e9;
+    printf("%-8s %-8s %12lld rows  %8.1f MB  %10.0f rows/s  %8.1f MB/s\n",
+           mix, path, rows, payload_bytes / 1048576.0,
+           secs > 0 ? rows / secs : 0.0, secs > 0 ? payload_bytes / 1048576.0 / secs : 0.0);
+}
+
+/* Row-format path: null byte + serializer call per value, exactly the
+ * inner loop of ExportToTrino()'s v1 format. */
+static int bench_row_path(const BenchMix_t *mix, unsigned char *pool, SendContext_t *ctx,
+                          long long total_rows, int batch_rows) {
+    FNC_TblOpColumnDef_t *iCols = (FNC_TblOpColumnDef_t *)malloc(TblOpSIZECOLDEF(mix->ncols));
+    ColumnSerializer_t sers[BENCH_MAX_COLS];
+    int proj[BENCH_MAX_COLS];
+    unsigned char *bb = (unsigned char *)malloc(BUFFER_SIZE);
+    if (!iCols || !bb) return -1;
+    TblOpINITCOLDEF(iCols, mix->ncols);
+    int c;
+    for (c = 0; c < mix->ncols; c++) {
+        iCols->column_types[c].datatype = mix->datatypes[c];
+        iCols->column_types[c].bytesize = mix->bytesizes[c];
+        iCols->column_types[c].charset = 1;
+        proj[c] = c;
+    }
+    build_column_serializers(sers, iCols, proj, mix->ncols);
+
+    long long r, payload = 0;
+    int batch_offset = 4, rows_in_batch = 0, seq = 0;
+    long long t0 = now_ns();
+    for (r = 0; r < total_rows; r++) {
+        unsigned char *row = pool + ((size_t)(r % BENCH_ROW_POOL) * mix->ncols) * BENCH_VAL_STRIDE;
+        for (c = 0; c < mix->ncols; c++) {
+            bb[batch_offset++] = 0;
+            batch_offset += sers[c].fn(bb + batch_offset, row + (size_t)c * BENCH_VAL_STRIDE, &sers[c]);
+        }
+        if (++rows_in_batch >= batch_rows || batch_offset > BUFFER_SIZE - 1048576) {
+            payload += batch_offset;
+            if (send_batch_to_bridge(ctx, bb, batch_offset, rows_in_batch, seq++) < 0) return -1;
+            batch_offset = 4; rows_in_batch = 0;
+        }
+    }
+    if (rows_in_batch > 0) {
+        payload += batch_offset;
+        if (send_batch_to_bridge(ctx, bb, batch_offset, rows_in_batch, seq++) < 0) return -1;
+    }
+    bench_report(mix->name, "row", total_rows, payload, now_ns() - t0);
+    free(bb); free(iCols);
+    return 0;
+}
+
+/* Columnar path: per-column staging plus assemble_columnar_batch, the v2
+ * format's main-thread work. */
+static int bench_columnar_path(const BenchMix_t *mix, unsigned char *pool, SendContext_t *ctx,
+                               long long total_rows, int batch_rows) {
+    ColumnBuffer_t cbufs[BENCH_MAX_COLS];
+    unsigned char *bb = (unsigned char *)malloc(BUFFER_SIZE);
+    int c;
+    if (!bb) return -1;
+    init_bswap_kernels();
+    for (c = 0; c < mix->ncols; c++) {
+        if (col_buf_init(&cbufs[c], mix->datatypes[c], batch_rows) < 0) return -1;
+    }
+
+    long long r, payload = 0;
+    int rows_in_batch = 0, seq = 0;
+    long long t0 = now_ns();
+    for (r = 0; r < total_rows; r++) {
+        unsigned char *row = pool + ((size_t)(r % BENCH_ROW_POOL) * mix->ncols) * BENCH_VAL_STRIDE;
+        for (c = 0; c < mix->ncols; c++) {
+            if (col_buf_append(&cbufs[c], rows_in_batch, mix->datatypes[c], 1,
+                               mix->bytesizes[c], row + (size_t)c * BENCH_VAL_STRIDE) < 0) return -1;
+        }
+        if (++rows_in_batch >= batch_rows) {
+            int blen = assemble_columnar_batch(bb, BUFFER_SIZE, cbufs, mix->ncols, rows_in_batch);
+            if (blen < 0 || send_batch_to_bridge(ctx, bb, blen, rows_in_batch, seq++) < 0) return -1;
+            payload += blen;
+            for (c = 0; c < mix->ncols; c++) col_buf_reset(&cbufs[c], batch_rows);
+            rows_in_batch = 0;
+        }
+    }
+    if (rows_in_batch > 0) {
+        int blen = assemble_columnar_batch(bb, BUFFER_SIZE, cbufs, mix->ncols, rows_in_batch);
+        if (blen < 0 || send_batch_to_bridge(ctx, bb, blen, rows_in_batch, seq++) < 0) return -1;
+        payload += blen;
+    }
+    bench_report(mix->name, "columnar", total_rows, payload, now_ns() - t0);
+    for (c = 0; c < mix->ncols; c++) col_buf_free(&cbufs[c]);
+    free(bb);
+    return 0;
+}
+
+static int bench_codec_from_name(const char *name) {
+    if (strcmp(name, "none") == 0) return COMPRESS_NONE;
+    if (strcmp(name, "zlib") == 0) return COMPRESS_ZLIB;
+    if (strcmp(name, "lz4") == 0) return COMPRESS_LZ4;
+    if (strcmp(name, "lz4s") == 0) return COMPRESS_LZ4_STREAM;
+    if (strcmp(name, "zstd") == 0) return COMPRESS_ZSTD;
+    if (strcmp(name, "adaptive") == 0) return COMPRESS_ADAPTIVE;
+    return -1;
+}
+
+int main(int argc, char **argv) {
+    long long total_rows = 2000000;
+    int batch_rows = 10000, codec = COMPRESS_NONE, accel = 1, zlevel = 0;
+    const char *mix_name = "all";
+    int opt;
+    while ((opt = getopt(argc, argv, "r:b:c:a:z:m:h")) != -1) {
+        switch (opt) {
+            case 'r': total_rows = atoll(optarg); break;
+            case 'b': batch_rows = atoi(optarg); break;
+            case 'c': codec = bench_codec_from_name(optarg); break;
+            case 'a': accel = atoi(optarg); break;
+            case 'z': zlevel = atoi(optarg); break;
+            case 'm': mix_name = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-r rows] [-b batch_rows] [-c none|zlib|lz4|lz4s|zstd|adaptive] [-a lz4_accel] [-z zstd_level] [-m int|bigint|decimal|varchar|mixed|all]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (codec < 0 || total_rows <= 0 || batch_rows <= 0) {
+        fprintf(stderr, "bad arguments\n");
+        return 2;
+    }
+#ifndef HAVE_ZSTD
+    if (codec == COMPRESS_ZSTD) {
+        fprintf(stderr, "built without HAVE_ZSTD\n");
+        return 2;
+    }
+#endif
+
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+        perror("socketpair");
+        return 1;
+    }
+    pthread_t drain;
+    pthread_create(&drain, NULL, bench_drain_main, &sv[1]);
+
+    printf("rows=%lld batch=%d codec=%d accel=%d zstd_level=%d\n",
+           total_rows, batch_rows, codec, accel, zlevel ? zlevel : ZSTD_DEFAULT_LEVEL);
+    int m, failed = 0;
+    for (m = 0; m < BENCH_NUM_MIXES; m++) {
+        const BenchMix_t *mix = &bench_mixes[m];
+        if (strcmp(mix_name, "all") != 0 && strcmp(mix_name, mix->name) != 0) continue;
+        unsigned char *pool = bench_fill_pool(mix);
+        if (!pool) { failed = 1; break; }
+        SendContext_t ctx;
+        bench_ctx_init(&ctx, sv[0], codec, accel, zlevel);
+        if (bench_row_path(mix, pool, &ctx, total_rows, batch_rows) < 0) failed = 1;
+        bench_ctx_free(&ctx);
+        bench_ctx_init(&ctx, sv[0], codec, accel, zlevel);
+        if (bench_columnar_path(mix, pool, &ctx, total_rows, batch_rows) < 0) failed = 1;
+        bench_ctx_free(&ctx);
+        free(pool);
+        if (failed) break;
+    }
+
+    shutdown(sv[0], SHUT_WR);
+    close(sv[0]);
+    pthread_join(drain, NULL);
+    close(sv[1]);
+    if (failed) fprintf(stderr, "benchmark failed\n");
+    return failed;
+}
@@ -91,7 +91,9 @@ void ExportToTrino(void)
                 inHandle = icolinfo[j].Handle;
                 iCols = icolinfo[j].iCols;
 
-                /* TODO: Arrow RecordBatch Building and Flight DoPut */
+                /* Arrow RecordBatch building and Flight DoPut live in
+                 * teradata_export.cpp (the teradata_export CMake target);
+                 * this C skeleton only accounts rows and bytes. */
 
                 rows_sent++;
                 
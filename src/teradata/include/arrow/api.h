@@ -9,6 +9,7 @@ namespace arrow {
     public:
         static Status OK() { return Status(true); }
         static Status OutOfMemory(const std::string& msg) { return Status(false); }
+        static Status Invalid(const std::string& msg) { return Status(false); }
         bool ok() const { return ok_; }
         void ValueOrDie() {}
         bool ValueOrDie() const { return true; }
@@ -17,6 +18,14 @@ namespace arrow {
         bool ok_;
     };
 
+#ifndef ARROW_RETURN_NOT_OK
+#define ARROW_RETURN_NOT_OK(expr)                  \
+    do {                                           \
+        ::arrow::Status _st = (expr);              \
+        if (!_st.ok()) return _st;                 \
+    } while (0)
+#endif
+
     template<typename T>
     class Result {
     public:
@@ -126,6 +135,9 @@ namespace arrow {
 
     class Decimal128 {
     public:
+        Decimal128() {}
+        explicit Decimal128(int64_t value) {}
+        Decimal128(int64_t high, uint64_t low) {}
         static Result<Decimal128> FromLittleEndian(const uint8_t* bytes, int length) { return Decimal128(); }
         void ValueOrDie() {}
         Decimal128 ValueOrDie() const { return *this; }
@@ -22,6 +22,7 @@ namespace flight {
     class FlightStreamWriter {
     public:
         Status WriteRecordBatch(const RecordBatch& batch) { return Status::OK(); }
+        Status DoneWriting() { return Status::OK(); }
         Status Close() { return Status::OK(); }
     };
 
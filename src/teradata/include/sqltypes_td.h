@@ -377,6 +377,41 @@ static inline int FNC_GetNextRow(void) {
     return TBL_NO_MORE_ROWS;
 }
 
+/* Legacy Table Function column descriptor (flat layout, used by the
+ * Arrow export path in teradata_export.cpp) */
+typedef struct {
+    DataType_t datatype;
+    int bytesize;
+    int precision;
+    int scale;
+    char column_name[FNC_MAXNAMELEN_EON];
+} FNC_TblColDef_t;
+
+/* Get input column metadata (legacy) */
+static inline int FNC_GetTblColumnsInfo(int *num_cols, FNC_TblColDef_t **columns) {
+    static FNC_TblColDef_t mock_cols[1] = {{INTEGER_DT, 4, 0, 0, "col_0"}};
+    *num_cols = 1;
+    *columns = mock_cols;
+    return 0;
+}
+
+/* Get one column value of the current row (legacy) */
+static inline int FNC_GetTblColValue(int col, void **val, int *length, int *null_ind) {
+    (void)col;
+    *val = 0;
+    *length = 0;
+    *null_ind = -1; /* Mock: always NULL */
+    return 0;
+}
+
+/* Get the next custom-clause argument (legacy) */
+static inline int FNC_GetTblNextArg(char *buf, int *length, int *null_ind) {
+    buf[0] = '\0';
+    *length = 0;
+    *null_ind = -1; /* Mock: no argument */
+    return 0;
+}
+
 /* ============================================================
  * Memory Functions
  * ============================================================ */
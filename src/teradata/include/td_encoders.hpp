@@ -0,0 +1,127 @@
+/**
+ * td_encoders.hpp - single source of truth for the Teradata type mapping on
+ * the C++ side of the export path.
+ *
+ * Every C++ consumer (the Arrow teradata_export target today; any future
+ * C++ serializer variant) resolves a column's *_DT code through dispatch()
+ * exactly once at column setup and gets back encoders specialized at
+ * compile time, so the per-value hot path carries no type switch. The
+ * legacy scripts/export_to_trino_v3.c..v7 generations each re-implemented
+ * this mapping by hand; new work goes here instead.
+ *
+ * The production socket UDF (src/teradata/export_to_trino.c) is compiled
+ * as C by the Teradata FNC toolchain and keeps its serializer-table
+ * equivalent of the same one-jump-per-column scheme; its wire encodings
+ * are the reference for the converters below.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "sqltypes_td.h"
+
+namespace td {
+
+/* Logical encoder categories. Several *_DT codes share one category
+ * (REAL/FLOAT, CHAR/VARCHAR); everything unknown degrades to Utf8, the
+ * same fallback the socket serializer uses. */
+enum class Kind { Int8, Int16, Int32, Int64, Float64, Date32, Decimal128, Utf8 };
+
+/* Compile-time traits per *_DT code. The primary template is left
+ * undefined so an unmapped code is a compile error at the specialization
+ * site rather than a silent mis-encode at runtime. */
+template <int DT> struct type_traits;
+
+template <> struct type_traits<BYTEINT_DT>  { using host_type = int8_t;  static constexpr Kind kind = Kind::Int8; };
+template <> struct type_traits<SMALLINT_DT> { using host_type = int16_t; static constexpr Kind kind = Kind::Int16; };
+template <> struct type_traits<INTEGER_DT>  { using host_type = int32_t; static constexpr Kind kind = Kind::Int32; };
+template <> struct type_traits<BIGINT_DT>   { using host_type = int64_t; static constexpr Kind kind = Kind::Int64; };
+template <> struct type_traits<REAL_DT>     { using host_type = double;  static constexpr Kind kind = Kind::Float64; };
+template <> struct type_traits<FLOAT_DT>    { using host_type = double;  static constexpr Kind kind = Kind::Float64; };
+template <> struct type_traits<DATE_DT>     { using host_type = int32_t; static constexpr Kind kind = Kind::Date32; };
+template <> struct type_traits<DECIMAL_DT>  { using host_type = void;    static constexpr Kind kind = Kind::Decimal128; };
+template <> struct type_traits<CHAR_DT>     { using host_type = void;    static constexpr Kind kind = Kind::Utf8; };
+template <> struct type_traits<VARCHAR_DT>  { using host_type = void;    static constexpr Kind kind = Kind::Utf8; };
+
+/* Map a runtime *_DT code to a call with its compile-time tag; the one
+ * runtime jump in the whole scheme. The callable is invoked with
+ * std::integral_constant<int, DT>, so `decltype(tag)::value` is usable in
+ * constexpr context inside. */
+template <typename F>
+decltype(auto) dispatch(int dt, F&& f) {
+    switch (dt) {
+        case BYTEINT_DT:  return f(std::integral_constant<int, BYTEINT_DT>{});
+        case SMALLINT_DT: return f(std::integral_constant<int, SMALLINT_DT>{});
+        case INTEGER_DT:  return f(std::integral_constant<int, INTEGER_DT>{});
+        case BIGINT_DT:   return f(std::integral_constant<int, BIGINT_DT>{});
+        case REAL_DT:     return f(std::integral_constant<int, REAL_DT>{});
+        case FLOAT_DT:    return f(std::integral_constant<int, FLOAT_DT>{});
+        case DATE_DT:     return f(std::integral_constant<int, DATE_DT>{});
+        case DECIMAL_DT:  return f(std::integral_constant<int, DECIMAL_DT>{});
+        case CHAR_DT:     return f(std::integral_constant<int, CHAR_DT>{});
+        case VARCHAR_DT:
+        default:          return f(std::integral_constant<int, VARCHAR_DT>{});
+    }
+}
+
+/* Unaligned load of a host value; Teradata row buffers give no alignment
+ * guarantee and memcpy is the only strict-aliasing-clean way in. */
+template <typename T>
+inline T load(const void* p) {
+    T v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+
+/* Civil-date math (no mktime: slow and timezone-sensitive), identical to
+ * ymd_to_epoch_days() in export_to_trino.c and constexpr so the anchors
+ * below are verified at compile time. */
+constexpr int32_t epoch_days_from_civil(int y, int m, int d) {
+    if (m <= 2) { y -= 1; m += 12; }
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153u * static_cast<unsigned>(m - 3) + 2u) / 5u + static_cast<unsigned>(d) - 1u;
+    const unsigned doe = yoe * 365u + yoe / 4u - yoe / 100u + doy;
+    return era * 146097 + static_cast<int>(doe) - 719468;
+}
+
+/* Teradata DATE int ((year-1900)*10000 + month*100 + day) to days since
+ * 1970-01-01. */
+constexpr int32_t epoch_days_from_td_date(int32_t td_date) {
+    int y = 1900 + td_date / 10000;
+    int md = td_date % 10000;
+    if (md < 0) { y--; md += 10000; }
+    return epoch_days_from_civil(y, md / 100, md % 100);
+}
+
+static_assert(epoch_days_from_td_date(700101) == 0, "1970-01-01 anchor");
+static_assert(epoch_days_from_td_date(1000229) == 11016, "2000-02-29 leap anchor");
+static_assert(epoch_days_from_td_date(-8769) == epoch_days_from_civil(1899, 12, 31),
+              "pre-1900 dates borrow a year");
+
+/* Teradata decimals are little-endian scaled integers of 1/2/4/8/16 bytes;
+ * narrow widths sign-extend into the canonical high/low 128-bit form. */
+struct decimal128_parts {
+    int64_t high;
+    uint64_t low;
+};
+
+inline decimal128_parts load_decimal128(const void* p, int length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(p);
+    if (length <= 8) {
+        int64_t v = 0;
+        std::memcpy(&v, bytes, length);
+        if (length < 8 && (bytes[length - 1] & 0x80)) {
+            v |= ~((int64_t(1) << (length * 8)) - 1);
+        }
+        return {v < 0 ? int64_t(-1) : int64_t(0), static_cast<uint64_t>(v)};
+    }
+    int64_t low, high;
+    std::memcpy(&low, bytes, 8);
+    std::memcpy(&high, bytes + 8, 8);
+    return {high, static_cast<uint64_t>(low)};
+}
+
+}  // namespace td
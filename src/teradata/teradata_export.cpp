@@ -0,0 +1,297 @@
+#define SQL_TEXT Latin_Text
+#include "sqltypes_td.h"
+#include "TeradataMemoryPool.h"
+#include "td_encoders.hpp"
+#include <arrow/api.h>
+#include <arrow/flight/api.h>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <string>
+#include <memory>
+
+using namespace td_export;
+
+// Arrow-side binding per td::Kind: the Arrow type, the builder and the
+// per-value appender. Each specialization is instantiated at compile time;
+// td::dispatch() picks one per column at setup, so the row loop calls a
+// resolved function pointer with no type switch.
+template <td::Kind K> struct ArrowBinding;
+
+template <> struct ArrowBinding<td::Kind::Int8> {
+    static std::shared_ptr<arrow::DataType> Type(const FNC_TblColDef_t&) { return arrow::int8(); }
+    static std::shared_ptr<arrow::ArrayBuilder> Builder(const FNC_TblColDef_t&, arrow::MemoryPool* pool) {
+        return std::make_shared<arrow::Int8Builder>(pool);
+    }
+    static arrow::Status Append(arrow::ArrayBuilder* b, const void* p, int) {
+        return static_cast<arrow::Int8Builder*>(b)->Append(td::load<int8_t>(p));
+    }
+};
+
+template <> struct ArrowBinding<td::Kind::Int16> {
+    static std::shared_ptr<arrow::DataType> Type(const FNC_TblColDef_t&) { return arrow::int16(); }
+    static std::shared_ptr<arrow::ArrayBuilder> Builder(const FNC_TblColDef_t&, arrow::MemoryPool* pool) {
+        return std::make_shared<arrow::Int16Builder>(pool);
+    }
+    static arrow::Status Append(arrow::ArrayBuilder* b, const void* p, int) {
+        return static_cast<arrow::Int16Builder*>(b)->Append(td::load<int16_t>(p));
+    }
+};
+
+template <> struct ArrowBinding<td::Kind::Int32> {
+    static std::shared_ptr<arrow::DataType> Type(const FNC_TblColDef_t&) { return arrow::int32(); }
+    static std::shared_ptr<arrow::ArrayBuilder> Builder(const FNC_TblColDef_t&, arrow::MemoryPool* pool) {
+        return std::make_shared<arrow::Int32Builder>(pool);
+    }
+    static arrow::Status Append(arrow::ArrayBuilder* b, const void* p, int) {
+        return static_cast<arrow::Int32Builder*>(b)->Append(td::load<int32_t>(p));
+    }
+};
+
+template <> struct ArrowBinding<td::Kind::Int64> {
+    static std::shared_ptr<arrow::DataType> Type(const FNC_TblColDef_t&) { return arrow::int64(); }
+    static std::shared_ptr<arrow::ArrayBuilder> Builder(const FNC_TblColDef_t&, arrow::MemoryPool* pool) {
+        return std::make_shared<arrow::Int64Builder>(pool);
+    }
+    static arrow::Status Append(arrow::ArrayBuilder* b, const void* p, int) {
+        return static_cast<arrow::Int64Builder*>(b)->Append(td::load<int64_t>(p));
+    }
+};
+
+template <> struct ArrowBinding<td::Kind::Float64> {
+    static std::shared_ptr<arrow::DataType> Type(const FNC_TblColDef_t&) { return arrow::float64(); }
+    static std::shared_ptr<arrow::ArrayBuilder> Builder(const FNC_TblColDef_t&, arrow::MemoryPool* pool) {
+        return std::make_shared<arrow::DoubleBuilder>(pool);
+    }
+    static arrow::Status Append(arrow::ArrayBuilder* b, const void* p, int) {
+        return static_cast<arrow::DoubleBuilder*>(b)->Append(td::load<double>(p));
+    }
+};
+
+template <> struct ArrowBinding<td::Kind::Date32> {
+    static std::shared_ptr<arrow::DataType> Type(const FNC_TblColDef_t&) { return arrow::date32(); }
+    static std::shared_ptr<arrow::ArrayBuilder> Builder(const FNC_TblColDef_t&, arrow::MemoryPool* pool) {
+        return std::make_shared<arrow::Date32Builder>(pool);
+    }
+    static arrow::Status Append(arrow::ArrayBuilder* b, const void* p, int) {
+        return static_cast<arrow::Date32Builder*>(b)->Append(
+            td::epoch_days_from_td_date(td::load<int32_t>(p)));
+    }
+};
+
+template <> struct ArrowBinding<td::Kind::Decimal128> {
+    static std::shared_ptr<arrow::DataType> Type(const FNC_TblColDef_t& col) {
+        return arrow::decimal128(col.precision, col.scale);
+    }
+    static std::shared_ptr<arrow::ArrayBuilder> Builder(const FNC_TblColDef_t& col, arrow::MemoryPool* pool) {
+        return std::make_shared<arrow::Decimal128Builder>(
+            arrow::decimal128(col.precision, col.scale), pool);
+    }
+    static arrow::Status Append(arrow::ArrayBuilder* b, const void* p, int length) {
+        td::decimal128_parts parts = td::load_decimal128(p, length);
+        return static_cast<arrow::Decimal128Builder*>(b)->Append(
+            arrow::Decimal128(parts.high, parts.low));
+    }
+};
+
+template <> struct ArrowBinding<td::Kind::Utf8> {
+    static std::shared_ptr<arrow::DataType> Type(const FNC_TblColDef_t&) { return arrow::utf8(); }
+    static std::shared_ptr<arrow::ArrayBuilder> Builder(const FNC_TblColDef_t&, arrow::MemoryPool* pool) {
+        return std::make_shared<arrow::StringBuilder>(pool);
+    }
+    static arrow::Status Append(arrow::ArrayBuilder* b, const void* p, int length) {
+        return static_cast<arrow::StringBuilder*>(b)->Append((const char*)p, length);
+    }
+};
+
+// A column's resolved encoders; built once per column by MakeEncoder.
+struct ColumnEncoder {
+    std::shared_ptr<arrow::DataType> (*type)(const FNC_TblColDef_t&);
+    std::shared_ptr<arrow::ArrayBuilder> (*builder)(const FNC_TblColDef_t&, arrow::MemoryPool*);
+    arrow::Status (*append)(arrow::ArrayBuilder*, const void*, int);
+};
+
+static ColumnEncoder MakeEncoder(const FNC_TblColDef_t& col) {
+    return td::dispatch(col.datatype, [](auto tag) {
+        using Binding = ArrowBinding<td::type_traits<decltype(tag)::value>::kind>;
+        return ColumnEncoder{&Binding::Type, &Binding::Builder, &Binding::Append};
+    });
+}
+
+// Helper to convert Teradata metadata to Arrow Schema
+std::shared_ptr<arrow::Schema> CreateArrowSchema(FNC_TblColDef_t* columns, int num_cols) {
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+
+    for (int i = 0; i < num_cols; ++i) {
+        std::string col_name = (char*)columns[i].column_name;
+        fields.push_back(arrow::field(col_name, MakeEncoder(columns[i]).type(columns[i])));
+    }
+
+    return std::make_shared<arrow::Schema>(fields);
+}
+
+// Finish all builders into a RecordBatch and ship it over the Flight stream.
+// The write is synchronous, so on return nothing references the arrays and
+// the caller may recycle the pool arena for the next batch.
+static arrow::Status FlushBatch(const std::shared_ptr<arrow::Schema>& schema,
+                                std::vector<std::shared_ptr<arrow::ArrayBuilder>>& builders,
+                                int64_t rows,
+                                arrow::flight::FlightStreamWriter* writer) {
+    std::vector<std::shared_ptr<arrow::Array>> arrays;
+    arrays.reserve(builders.size());
+    for (auto& b : builders) {
+        std::shared_ptr<arrow::Array> arr;
+        ARROW_RETURN_NOT_OK(b->Finish(&arr));
+        arrays.push_back(std::move(arr));
+    }
+    auto batch = arrow::RecordBatch::Make(schema, rows, std::move(arrays));
+    return writer->WriteRecordBatch(*batch);
+}
+
+// Pick this AMP's endpoint from a comma-separated host[:port] list, the same
+// spreading parse_params_from_stream() does in export_to_trino.c.
+static void SelectEndpoint(const char* target_ips, int amp_id, std::string* host, int* port) {
+    std::vector<std::string> entries;
+    const char* p = target_ips;
+    while (*p) {
+        const char* comma = std::strchr(p, ',');
+        size_t len = comma ? (size_t)(comma - p) : std::strlen(p);
+        while (len > 0 && *p == ' ') { p++; len--; }
+        if (len > 0) entries.emplace_back(p, len);
+        p = comma ? comma + 1 : p + len;
+    }
+    *host = "127.0.0.1";
+    *port = 50051;
+    if (entries.empty()) return;
+    const std::string& chosen = entries[amp_id % entries.size()];
+    size_t colon = chosen.find(':');
+    if (colon == std::string::npos) {
+        *host = chosen;
+    } else {
+        *host = chosen.substr(0, colon);
+        *port = std::atoi(chosen.c_str() + colon + 1);
+    }
+}
+
+// The whole export as a Status-returning pipeline; *stage identifies the step
+// that failed so the wrapper can map it to a distinct SQLSTATE.
+static arrow::Status RunExport(TeradataMemoryPool* pool, int* stage) {
+    *stage = 1;
+    int num_cols;
+    FNC_TblColDef_t* columns;
+    if (FNC_GetTblColumnsInfo(&num_cols, &columns) != 0) {
+        return arrow::Status::Invalid("FNC_GetTblColumnsInfo failed");
+    }
+    auto schema = CreateArrowSchema(columns, num_cols);
+
+    *stage = 2;
+    char target_ips[256];
+    char query_id[64];
+    int length, null_ind;
+    if (FNC_GetTblNextArg(target_ips, &length, &null_ind) != 0 || null_ind == -1) {
+        return arrow::Status::Invalid("Missing target host list argument");
+    }
+    *stage = 3;
+    if (FNC_GetTblNextArg(query_id, &length, &null_ind) != 0 || null_ind == -1) {
+        return arrow::Status::Invalid("Missing query id argument");
+    }
+
+    *stage = 4;
+    std::string host;
+    int port;
+    SelectEndpoint(target_ips, FNC_GetAmpId(), &host, &port);
+    arrow::flight::Location location;
+    ARROW_RETURN_NOT_OK(arrow::flight::Location::ForGrpcTcp(host, port, &location));
+    std::unique_ptr<arrow::flight::FlightClient> client;
+    ARROW_RETURN_NOT_OK(arrow::flight::FlightClient::Connect(location, &client));
+
+    *stage = 5;
+    auto descriptor = arrow::flight::FlightDescriptor::Path({std::string(query_id)});
+    arrow::flight::FlightCallOptions options;
+    options.headers.push_back({"authorization", "Bearer " + std::string(query_id)});
+    std::unique_ptr<arrow::flight::FlightStreamWriter> writer;
+    std::unique_ptr<arrow::flight::FlightMetadataReader> reader;
+    ARROW_RETURN_NOT_OK(client->DoPut(options, descriptor, schema, &writer, &reader));
+
+    *stage = 6;
+    // Resolve each column's encoders once; the row loop below never looks
+    // at a datatype code again.
+    std::vector<ColumnEncoder> encoders;
+    encoders.reserve(num_cols);
+    for (int i = 0; i < num_cols; ++i) {
+        encoders.push_back(MakeEncoder(columns[i]));
+    }
+
+    std::vector<std::shared_ptr<arrow::ArrayBuilder>> builders;
+    builders.reserve(num_cols);
+    for (int i = 0; i < num_cols; ++i) {
+        builders.push_back(encoders[i].builder(columns[i], pool));
+    }
+
+    // Rebuild the builders and rewind the pool arena between batches: once
+    // the RecordBatch has been written, dropping the builders releases the
+    // last references into the arena, so ResetBatch() can recycle the slabs
+    // instead of round-tripping every buffer through FNC allocation.
+    auto recycle_batch = [&]() {
+        builders.clear();
+        pool->ResetBatch();
+        for (int i = 0; i < num_cols; ++i) {
+            builders.push_back(encoders[i].builder(columns[i], pool));
+        }
+    };
+
+    int64_t rows_in_batch = 0;
+    while (FNC_GetNextRow() == TBL_row) {
+        for (int i = 0; i < num_cols; ++i) {
+            void* val_ptr;
+            int val_len, val_null;
+            FNC_GetTblColValue(i, &val_ptr, &val_len, &val_null);
+
+            if (val_null == -1) {
+                ARROW_RETURN_NOT_OK(builders[i]->AppendNull());
+            } else {
+                ARROW_RETURN_NOT_OK(encoders[i].append(builders[i].get(), val_ptr, val_len));
+            }
+        }
+
+        rows_in_batch++;
+        if (rows_in_batch >= 10000) {
+            ARROW_RETURN_NOT_OK(FlushBatch(schema, builders, rows_in_batch, writer.get()));
+            recycle_batch();
+            rows_in_batch = 0;
+        }
+    }
+
+    if (rows_in_batch > 0) {
+        ARROW_RETURN_NOT_OK(FlushBatch(schema, builders, rows_in_batch, writer.get()));
+    }
+
+    ARROW_RETURN_NOT_OK(writer->DoneWriting());
+    return writer->Close();
+}
+
+extern "C" void ExportToTrino(void *input, void *result, char sqlstate[6]) {
+    FNC_Phase phase;
+    if (FNC_GetPhase(&phase) != TBL_MODE_CONST) {
+        if (phase == TBL_PRE_EXE) {
+            // Contract phase: output table structure is set via FNC_TblControl
+            // by the deployment DDL; nothing to negotiate here.
+        }
+        return;
+    }
+
+    // --- Execution Phase ---
+    TeradataMemoryPool pool;
+
+    int stage = 0;
+    arrow::Status status = RunExport(&pool, &stage);
+    if (!status.ok()) {
+        char code[8];
+        std::snprintf(code, sizeof(code), "U%04d", stage > 0 ? stage : 99);
+        std::strncpy(sqlstate, code, 5);
+        return;
+    }
+    (void)input;
+    (void)result;
+}
@@ -13,6 +13,7 @@ import java.util.concurrent.*;
 import java.util.concurrent.atomic.AtomicLong;
 import java.util.zip.Inflater;
 import io.airlift.compress.lz4.Lz4Decompressor;
+import io.airlift.compress.zstd.ZstdDecompressor;
 import java.util.zip.DataFormatException;
 
 /**
@@ -27,7 +28,8 @@ public final class AsyncDecompressionPipeline {
 
     private final String queryId;
     private final List<DirectTrinoPageParser.ColumnSpec> columns;
-    private final int compressionType; // 0=None, 1=ZLIB, 2=LZ4
+    private final int compressionType; // 0=None, 1=ZLIB, 2=LZ4, 3=ZSTD, 4=LZ4_STREAM, 5=ADAPTIVE
+    private final int batchFormat;     // 1=row-interleaved, 2=columnar
     private final ByteBufferPool bufferPool;
 
     // Queues for async pipeline
@@ -47,7 +49,7 @@ public final class AsyncDecompressionPipeline {
             
     private final CountDownLatch workerLatch;
 
-    public record CompressedBatch(byte[] data, int length, boolean isEndMarker) {}
+    public record CompressedBatch(byte[] data, int length, int codec, boolean isEndMarker) {}
 
     public AsyncDecompressionPipeline(
             String queryId,
@@ -55,22 +57,38 @@ public final class AsyncDecompressionPipeline {
             int compressionType,
             int queueCapacity,
             int decompressorThreads) {
+        this(queryId, columns, compressionType, 1, queueCapacity, decompressorThreads);
+    }
+
+    public AsyncDecompressionPipeline(
+            String queryId,
+            List<DirectTrinoPageParser.ColumnSpec> columns,
+            int compressionType,
+            int batchFormat,
+            int queueCapacity,
+            int decompressorThreads) {
 
         this.queryId = queryId;
         this.columns = columns;
         this.compressionType = compressionType;
+        this.batchFormat = batchFormat;
         this.compressedQueue = new ArrayBlockingQueue<>(queueCapacity);
-        this.bufferPool = new ByteBufferPool(decompressorThreads * 2, 64 * 1024 * 1024);
-        this.workerLatch = new CountDownLatch(decompressorThreads);
-        
-        this.decompressionPool = Executors.newFixedThreadPool(decompressorThreads, r -> {
+
+        // Streaming LZ4 (type 4) keeps a cross-batch dictionary, so its
+        // batches must decode in wire order: run exactly one worker, which
+        // drains the queue sequentially
+        int workers = (compressionType == 4) ? 1 : decompressorThreads;
+        this.bufferPool = new ByteBufferPool(workers * 2, 64 * 1024 * 1024);
+        this.workerLatch = new CountDownLatch(workers);
+
+        this.decompressionPool = Executors.newFixedThreadPool(workers, r -> {
             Thread t = new Thread(r, "async-decompress-" + queryId.substring(Math.max(0, queryId.length() - 8)));
             t.setDaemon(true);
             return t;
         });
 
         // Start decompression workers
-        for (int i = 0; i < decompressorThreads; i++) {
+        for (int i = 0; i < workers; i++) {
             decompressionPool.submit(this::decompressAndParseWorker);
         }
     }
@@ -80,7 +98,16 @@ public final class AsyncDecompressionPipeline {
      * Called by network reader thread.
      */
     public void submitCompressedBatch(byte[] data, int length) throws InterruptedException {
-        compressedQueue.put(new CompressedBatch(data, length, false));
+        submitCompressedBatch(data, length, compressionType);
+    }
+
+    /**
+     * Submit a batch whose codec differs from the connection's: ADAPTIVE (5)
+     * frames carry a per-batch codec byte of NONE or LZ4, which the network
+     * reader strips and passes here.
+     */
+    public void submitCompressedBatch(byte[] data, int length, int batchCodec) throws InterruptedException {
+        compressedQueue.put(new CompressedBatch(data, length, batchCodec, false));
         compressedBytes.addAndGet(length);
     }
 
@@ -88,7 +115,7 @@ public final class AsyncDecompressionPipeline {
      * Signal end of data stream.
      */
     public void signalEndOfStream() throws InterruptedException {
-        compressedQueue.put(new CompressedBatch(null, 0, true));
+        compressedQueue.put(new CompressedBatch(null, 0, 0, true));
     }
 
     public boolean isFinished() {
@@ -118,8 +145,13 @@ public final class AsyncDecompressionPipeline {
         try {
             // Create own Inflater instance for this worker
             inflater = (compressionType == 1) ? new Inflater() : null;
-            Lz4Decompressor lz4Decompressor = (compressionType == 2) ? new Lz4Decompressor() : null;
-            
+            // ADAPTIVE (5) batches carry a per-batch codec of NONE or LZ4
+            Lz4Decompressor lz4Decompressor = (compressionType == 2 || compressionType == 5) ? new Lz4Decompressor() : null;
+            ZstdDecompressor zstdDecompressor = (compressionType == 3) ? new ZstdDecompressor() : null;
+            // Streaming LZ4 dictionary state; the constructor runs a single
+            // worker for type 4, so wire order is preserved through the queue
+            Lz4StreamingDecoder streamDecoder = (compressionType == 4) ? new Lz4StreamingDecoder(decompressionBuffer.length) : null;
+
             while (!finished) {
                 CompressedBatch batch = compressedQueue.poll(100, TimeUnit.MILLISECONDS);
                 if (batch == null) continue;
@@ -131,28 +163,45 @@ public final class AsyncDecompressionPipeline {
                     break;
                 }
 
+                // ADAPTIVE batches pick their codec per frame; every other
+                // connection type matches the handshake codec
+                int codec = batch.codec();
                 byte[] decompressed;
                 int decompressedLen;
+                int payloadOffset = 0;
 
-                if (compressionType == 1) { /* ZLIB */
+                if (codec == 1) { /* ZLIB */
                     inflater.reset();
                     inflater.setInput(batch.data, 0, batch.length);
                     decompressedLen = inflater.inflate(decompressionBuffer);
                     decompressed = decompressionBuffer;
-                } else if (compressionType == 2) { /* LZ4 */
+                } else if (codec == 2) { /* LZ4 */
                     // LZ4 decompression requires destination size or we can use the aircompressor version
                     // The aircompressor LZ4Decompressor.decompress(input, inputOffset, inputLength, output, outputOffset, maxOutputLength)
                     decompressedLen = lz4Decompressor.decompress(batch.data, 0, batch.length, decompressionBuffer, 0, decompressionBuffer.length);
                     decompressed = decompressionBuffer;
-                } else { /* NONE */
+                } else if (codec == 3) { /* ZSTD */
+                    decompressedLen = zstdDecompressor.decompress(batch.data, 0, batch.length, decompressionBuffer, 0, decompressionBuffer.length);
+                    decompressed = decompressionBuffer;
+                } else if (codec == 4) { /* LZ4 streaming */
+                    decompressedLen = streamDecoder.decompress(batch.data, 0, batch.length);
+                    decompressed = streamDecoder.buffer();
+                    payloadOffset = streamDecoder.dataOffset();
+                } else if (codec == 0) { /* NONE */
                     decompressed = batch.data;
                     decompressedLen = batch.length;
+                } else {
+                    // Never fall through to pass-through: parsing compressed
+                    // bytes as payload corrupts data instead of failing
+                    throw new IllegalStateException("Unknown compression type " + codec + " for query " + queryId);
                 }
 
                 decompressedBytes.addAndGet(decompressedLen);
 
                 // Parse directly to Trino Page
-                Page page = DirectTrinoPageParser.parseDirectToPage(decompressed, decompressedLen, columns);
+                Page page = (batchFormat == 2)
+                        ? DirectTrinoPageParser.parseColumnarToPage(decompressed, payloadOffset, decompressedLen, columns)
+                        : DirectTrinoPageParser.parseDirectToPage(decompressed, payloadOffset, decompressedLen, columns);
                 if (page != null) {
                     int rowCount = page.getPositionCount();
                     totalRows.addAndGet(rowCount);
@@ -217,7 +266,10 @@ public final class AsyncDecompressionPipeline {
             String name = extractJsonString(colJson, "name");
             String type = extractJsonString(colJson, "type");
             if (name != null && type != null && typeIdx < trinoTypes.size()) {
-                columns.add(new DirectTrinoPageParser.ColumnSpec(name, type, trinoTypes.get(typeIdx)));
+                // CHARTRIM exports annotate trimmed CHAR columns with their
+                // declared character width so the parser can restore padding
+                int padTo = extractJsonInt(colJson, "padTo");
+                columns.add(new DirectTrinoPageParser.ColumnSpec(name, type, trinoTypes.get(typeIdx), padTo));
                 typeIdx++;
             }
             pos = objEnd + 1;
@@ -225,6 +277,17 @@ public final class AsyncDecompressionPipeline {
         return columns;
     }
 
+    private static int extractJsonInt(String json, String key) {
+        String searchKey = "\"" + key + "\":";
+        int start = json.indexOf(searchKey);
+        if (start < 0) return 0;
+        start += searchKey.length();
+        int end = start;
+        while (end < json.length() && Character.isDigit(json.charAt(end))) end++;
+        if (end == start) return 0;
+        return Integer.parseInt(json.substring(start, end));
+    }
+
     private static String extractJsonString(String json, String key) {
         String searchKey = "\"" + key + "\":\"";
         int start = json.indexOf(searchKey);
@@ -4,6 +4,7 @@ import io.trino.spi.Page;
 import io.trino.spi.type.Type;
 import java.util.List;
 import java.util.Map;
+import java.util.TreeMap;
 import java.util.concurrent.BlockingQueue;
 import java.util.concurrent.ConcurrentHashMap;
 import java.util.concurrent.LinkedBlockingQueue;
@@ -34,7 +35,30 @@ public class DataBufferRegistry {
     
     // Dynamic per-query token storage for security
     private static final Map<String, String> dynamicTokenRegistry = new ConcurrentHashMap<>();
-    
+
+    // Reorder state for striped exports, keyed "queryId#groupId". Each striped
+    // socket is its own group with its own contiguous sequence space - one
+    // AMP's stripes may terminate at different worker JVMs, so ordering is
+    // only ever defined per connection. TCP already delivers a connection's
+    // frames in sequence; pages park only when a resume reconnect lands
+    // mid-space, and are flushed when the connection closes.
+    private static final Map<String, StripeGroup> stripeGroups = new ConcurrentHashMap<>();
+
+    // Live data sockets per query, so completed dynamic filters can be pushed
+    // back down to the AMPs mid-export. Data flows AMP -> bridge; the filter
+    // frame travels the other direction on the same TCP connection.
+    private static final Map<String, java.util.Set<java.net.Socket>> dataSockets = new ConcurrentHashMap<>();
+
+    // Resume mode: batch sequences already accepted per queryId#stripeGroup,
+    // so replayed batches after an AMP reconnect are pushed exactly once
+    private static final Map<String, java.util.Set<Integer>> acceptedSequences = new ConcurrentHashMap<>();
+
+    // Zone-map pruning: per-query allowed [lo, hi] per column ordinal, in
+    // the raw stored-integer semantics the filter specs use. Derived from
+    // pushed dynamic filters; batches whose zone map is disjoint from every
+    // bound are dropped by the bridge before decompression.
+    private static final Map<String, Map<Integer, long[]>> zoneBounds = new ConcurrentHashMap<>();
+
     // Scheduler for short-lived EOS timing checks only (ms-scale delays, not TTL cleanup)
     private static final ScheduledExecutorService eosScheduler = Executors.newSingleThreadScheduledExecutor(r -> {
         Thread t = new Thread(r, "data-buffer-eos-scheduler");
@@ -164,6 +188,107 @@ public class DataBufferRegistry {
         }
     }
 
+    private static class StripeGroup {
+        final TreeMap<Integer, Page> pending = new TreeMap<>();
+        int nextSeq = 0;
+    }
+
+    /**
+     * Register the reorder buffer for one striped connection. Each connection
+     * carries a unique group id; idempotent, so a resume replay of the
+     * handshake reuses the group it left behind.
+     */
+    public static void registerStripeGroup(String queryId, int groupId) {
+        stripeGroups.computeIfAbsent(queryId + "#" + groupId, k -> new StripeGroup());
+    }
+
+    /**
+     * Record a batch sequence for a resume-mode connection. Returns false if
+     * that sequence was already accepted, i.e. the batch is a replay and must
+     * not be pushed again.
+     */
+    public static boolean markSequence(String queryId, int groupId, int seq) {
+        return acceptedSequences
+                .computeIfAbsent(queryId + "#" + groupId, k -> ConcurrentHashMap.newKeySet())
+                .add(seq);
+    }
+
+    /**
+     * Push a page from a striped connection. Pages are released to the query
+     * buffer in sequence order within the group; out-of-order arrivals are
+     * parked until the gap fills.
+     */
+    public static void pushDataOrdered(String queryId, int groupId, int seq, Page page) {
+        StripeGroup group = stripeGroups.get(queryId + "#" + groupId);
+        if (group == null) {
+            pushData(queryId, page);
+            return;
+        }
+        synchronized (group) {
+            if (seq != group.nextSeq) {
+                group.pending.put(seq, page);
+                return;
+            }
+            pushData(queryId, page);
+            group.nextSeq++;
+            drainPending(queryId, group);
+        }
+    }
+
+    /**
+     * Advance a stripe group's reorder sequence past a batch the bridge
+     * dropped (zone-map pruning) without releasing a page for it. A null
+     * marker is parked when the skipped sequence is still ahead of the
+     * cursor.
+     */
+    public static void skipSequenceOrdered(String queryId, int groupId, int seq) {
+        StripeGroup group = stripeGroups.get(queryId + "#" + groupId);
+        if (group == null) {
+            return;
+        }
+        synchronized (group) {
+            if (seq != group.nextSeq) {
+                group.pending.put(seq, null);
+                return;
+            }
+            group.nextSeq++;
+            drainPending(queryId, group);
+        }
+    }
+
+    /** Release consecutive parked pages; null markers only move the cursor. */
+    private static void drainPending(String queryId, StripeGroup group) {
+        while (!group.pending.isEmpty() && group.pending.firstKey() == group.nextSeq) {
+            Page page = group.pending.pollFirstEntry().getValue();
+            if (page != null) {
+                pushData(queryId, page);
+            }
+            group.nextSeq++;
+        }
+    }
+
+    /**
+     * Called when a striped connection finishes. Any gap-stranded pages are
+     * flushed in sequence order (a resume reconnect can land mid-space and
+     * park everything behind a hole) and the reorder state is dropped.
+     */
+    public static void closeStripeConnection(String queryId, int groupId) {
+        String key = queryId + "#" + groupId;
+        StripeGroup group = stripeGroups.get(key);
+        if (group == null) {
+            return;
+        }
+        synchronized (group) {
+            for (Page page : group.pending.values()) {
+                if (page != null) {
+                    pushData(queryId, page);
+                }
+            }
+            group.pending.clear();
+        }
+        stripeGroups.remove(key);
+    }
+
     public static void setBufferQueueCapacity(int capacity) {
         bufferQueueCapacity = capacity;
         log.debug("DataBufferRegistry queue capacity set to %d", capacity);
@@ -228,8 +353,12 @@ public class DataBufferRegistry {
             // Also clean up schema registry, token registry, and performance profiler entries
             schemaRegistry.remove(queryId);
             dynamicTokenRegistry.remove(queryId);
+            stripeGroups.keySet().removeIf(k -> k.startsWith(queryId + "#"));
+            acceptedSequences.keySet().removeIf(k -> k.startsWith(queryId + "#"));
+            zoneBounds.remove(queryId);
+            dataSockets.remove(queryId);
             PerformanceProfiler.clear(queryId);
-            
+
             log.debug("Deregistered buffer, schema, and profiler for query %s. All %d consumers finished.", queryId, finished);
             while (!buffer.queue.isEmpty()) {
                 BatchContainer container = buffer.queue.poll();
@@ -278,6 +407,124 @@ public class DataBufferRegistry {
         }
     }
 
+    public static void registerDataSocket(String queryId, java.net.Socket socket) {
+        dataSockets.computeIfAbsent(queryId, k -> ConcurrentHashMap.newKeySet()).add(socket);
+    }
+
+    public static void unregisterDataSocket(String queryId, java.net.Socket socket) {
+        java.util.Set<java.net.Socket> sockets = dataSockets.get(queryId);
+        if (sockets != null) {
+            sockets.remove(socket);
+            if (sockets.isEmpty()) {
+                dataSockets.remove(queryId, sockets);
+            }
+        }
+    }
+
+    /**
+     * Push a dynamic filter spec down every open data connection of a query.
+     * The AMPs poll for the [CONTROL_MAGIC][length][spec] frame between
+     * batches and start dropping non-matching rows before serialization.
+     * A connection that already closed simply misses the update; the rows it
+     * sent are still correct, just unfiltered.
+     */
+    /**
+     * Fold a filter spec ("col:OP:value" parts joined by ';') into the
+     * query's zone-map bounds. EQ/GE/GT/LE/LT narrow a column's [lo, hi];
+     * an IN list narrows to its span. Repeated pushes intersect, so a
+     * tightening dynamic filter only shrinks the bounds.
+     */
+    private static void applyZoneBoundsFromSpec(String queryId, String filterSpec) {
+        Map<Integer, long[]> bounds = zoneBounds.computeIfAbsent(queryId, k -> new ConcurrentHashMap<>());
+        for (String part : filterSpec.split(";")) {
+            String[] fields = part.split(":", 3);
+            if (fields.length < 3) {
+                continue;
+            }
+            int col;
+            try {
+                col = Integer.parseInt(fields[0].trim());
+            } catch (NumberFormatException e) {
+                continue;
+            }
+            long[] range = bounds.computeIfAbsent(col, k -> new long[] {Long.MIN_VALUE, Long.MAX_VALUE});
+            try {
+                switch (fields[1]) {
+                    case "EQ" -> {
+                        long v = Long.parseLong(fields[2].trim());
+                        range[0] = Math.max(range[0], v);
+                        range[1] = Math.min(range[1], v);
+                    }
+                    case "GE" -> range[0] = Math.max(range[0], Long.parseLong(fields[2].trim()));
+                    case "GT" -> range[0] = Math.max(range[0], Long.parseLong(fields[2].trim()) + 1);
+                    case "LE" -> range[1] = Math.min(range[1], Long.parseLong(fields[2].trim()));
+                    case "LT" -> range[1] = Math.min(range[1], Long.parseLong(fields[2].trim()) - 1);
+                    case "IN" -> {
+                        long lo = Long.MAX_VALUE;
+                        long hi = Long.MIN_VALUE;
+                        for (String v : fields[2].split(",")) {
+                            long x = Long.parseLong(v.trim());
+                            lo = Math.min(lo, x);
+                            hi = Math.max(hi, x);
+                        }
+                        range[0] = Math.max(range[0], lo);
+                        range[1] = Math.min(range[1], hi);
+                    }
+                    default -> { /* NN and unknown ops never narrow a range */ }
+                }
+            } catch (NumberFormatException e) {
+                // Malformed literal: leave the range as-is rather than mis-prune
+            }
+        }
+    }
+
+    /**
+     * True when a batch's zone map proves every row falls outside the
+     * query's bounds on at least one column. No bounds means no pruning.
+     */
+    public static boolean zoneMapExcludes(String queryId, long[][] zoneMap) {
+        Map<Integer, long[]> bounds = zoneBounds.get(queryId);
+        if (bounds == null || bounds.isEmpty()) {
+            return false;
+        }
+        for (long[] entry : zoneMap) {
+            long[] range = bounds.get((int) entry[0]);
+            if (range != null && (entry[2] < range[0] || entry[1] > range[1])) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    public static void pushDynamicFilter(String queryId, String filterSpec) {
+        applyZoneBoundsFromSpec(queryId, filterSpec);
+        java.util.Set<java.net.Socket> sockets = dataSockets.get(queryId);
+        if (sockets == null || sockets.isEmpty()) {
+            log.debug("No open data connections for query %s; dynamic filter not pushed", queryId);
+            return;
+        }
+        byte[] payload = filterSpec.getBytes(java.nio.charset.StandardCharsets.UTF_8);
+        int pushed = 0;
+        for (java.net.Socket socket : sockets) {
+            try {
+                // Serialize per socket: the handler thread interleaves credit
+                // grants on the same back channel, and two control connections
+                // could also race each other
+                synchronized (socket) {
+                    java.io.DataOutputStream out = new java.io.DataOutputStream(socket.getOutputStream());
+                    out.writeInt(TeradataBridgeServer.CONTROL_MAGIC);
+                    out.writeInt(payload.length);
+                    out.write(payload);
+                    out.flush();
+                }
+                pushed++;
+            } catch (Exception e) {
+                log.warn("Failed to push dynamic filter to a worker for query %s: %s", queryId, e.getMessage());
+            }
+        }
+        log.info("Pushed dynamic filter to %d/%d connections for query %s: %s", pushed, sockets.size(), queryId, filterSpec);
+    }
+
     /**
      * Mark that JDBC execution is finished globally.
      * This may trigger EOS if all connections are already closed.
@@ -325,6 +572,10 @@ public class DataBufferRegistry {
         queryBuffers.remove(queryId);
         schemaRegistry.remove(queryId);
         dynamicTokenRegistry.remove(queryId);
+        stripeGroups.keySet().removeIf(k -> k.startsWith(queryId + "#"));
+        acceptedSequences.keySet().removeIf(k -> k.startsWith(queryId + "#"));
+        zoneBounds.remove(queryId);
+        dataSockets.remove(queryId);
         PerformanceProfiler.clear(queryId);
         
         // Clear the queue
@@ -424,6 +675,8 @@ public class DataBufferRegistry {
         queryBuffers.clear();
         schemaRegistry.clear();
         dynamicTokenRegistry.clear();
+        stripeGroups.clear();
+        dataSockets.clear();
         log.debug("DataBufferRegistry shutdown complete. Cleared all buffers, schemas, and tokens.");
     }
 }
@@ -17,6 +17,7 @@ import java.util.List;
 import static io.trino.spi.type.BigintType.BIGINT;
 import static io.trino.spi.type.DoubleType.DOUBLE;
 import static io.trino.spi.type.IntegerType.INTEGER;
+import static io.trino.spi.type.VarbinaryType.VARBINARY;
 import static io.trino.spi.type.VarcharType.VARCHAR;
 
 /**
@@ -64,14 +65,52 @@ public final class DirectTrinoPageParser {
         }
     }
 
-    public record ColumnSpec(String name, String type, Type trinoType) {}
+    /**
+     * padTo is the declared character width of a CHARTRIM-trimmed CHAR
+     * column (0 for everything else); see {@link #repadChar}.
+     */
+    public record ColumnSpec(String name, String type, Type trinoType, int padTo) {
+        public ColumnSpec(String name, String type, Type trinoType) {
+            this(name, type, trinoType, 0);
+        }
+    }
+
+    /**
+     * CHARTRIM: the AMP strips trailing blanks from CHAR values before
+     * sending. Restore the declared padding when the Trino column type keeps
+     * it (VARCHAR does); CHAR-typed columns stay trimmed, since Trino stores
+     * CHAR values without trailing spaces anyway.
+     */
+    private static io.airlift.slice.Slice repadChar(io.airlift.slice.Slice value, ColumnSpec spec) {
+        if (spec.trinoType() instanceof io.trino.spi.type.CharType) {
+            return value;
+        }
+        // padTo counts characters; count UTF-8 code points (non-continuation bytes)
+        int chars = 0;
+        for (int i = 0; i < value.length(); i++) {
+            if ((value.getByte(i) & 0xC0) != 0x80) {
+                chars++;
+            }
+        }
+        if (chars >= spec.padTo()) {
+            return value;
+        }
+        byte[] padded = new byte[value.length() + (spec.padTo() - chars)];
+        value.getBytes(0, padded, 0, value.length());
+        java.util.Arrays.fill(padded, value.length(), padded.length, (byte) ' ');
+        return Slices.wrappedBuffer(padded);
+    }
 
     /**
      * Parse Teradata binary batch directly to Trino Page.
      * This iterates the row-oriented buffer and builds columnar blocks on the fly.
      */
     public static Page parseDirectToPage(byte[] data, int length, List<ColumnSpec> columns) {
-        ByteBuffer buf = ByteBuffer.wrap(data, 0, length);
+        return parseDirectToPage(data, 0, length, columns);
+    }
+
+    public static Page parseDirectToPage(byte[] data, int offset, int length, List<ColumnSpec> columns) {
+        ByteBuffer buf = ByteBuffer.wrap(data, offset, length);
         
         // Safety check for empty buffer
         if (buf.remaining() < 4) {
@@ -117,6 +156,163 @@ public final class DirectTrinoPageParser {
         return new Page(numRows, blocks);
     }
 
+    /**
+     * Parse a columnar (v2) batch directly to a Trino Page.
+     *
+     * Layout: [rows][cols] then per column a null bitmap (bit set = NULL,
+     * LSB-first) followed by either a packed vector of big-endian fixed-width
+     * values (null slots zero-filled) or int32 offsets plus concatenated bytes
+     * for character data. Values for one column are adjacent, so this walks
+     * each column in a tight per-type loop instead of dispatching per value.
+     */
+    public static Page parseColumnarToPage(byte[] data, int length, List<ColumnSpec> columns) {
+        return parseColumnarToPage(data, 0, length, columns);
+    }
+
+    public static Page parseColumnarToPage(byte[] data, int offset, int length, List<ColumnSpec> columns) {
+        ByteBuffer buf = ByteBuffer.wrap(data, offset, length);
+
+        if (buf.remaining() < 8) {
+            return new Page(0);
+        }
+
+        int numRows = buf.getInt();
+        int numCols = buf.getInt();
+        if (numRows == 0) {
+            return new Page(0);
+        }
+        if (numCols != columns.size()) {
+            throw new RuntimeException("Columnar batch has " + numCols + " columns, expected " + columns.size());
+        }
+
+        int bitmapBytes = (numRows + 7) / 8;
+        Block[] blocks = new Block[numCols];
+
+        try {
+            for (int col = 0; col < numCols; col++) {
+                ColumnSpec spec = columns.get(col);
+                byte[] nulls = new byte[bitmapBytes];
+                buf.get(nulls);
+                BlockBuilder builder = spec.trinoType().createBlockBuilder(null, numRows);
+                appendColumn(buf, builder, spec, nulls, numRows);
+                blocks[col] = builder.build();
+            }
+        } catch (Exception e) {
+            log.error(e, "Error parsing columnar batch. Offset: %d, Length: %d", buf.position(), length);
+            throw new RuntimeException("Error parsing Teradata columnar batch", e);
+        }
+
+        return new Page(numRows, blocks);
+    }
+
+    private static boolean isNull(byte[] nulls, int row) {
+        return (nulls[row >> 3] & (1 << (row & 7))) != 0;
+    }
+
+    private static void appendColumn(ByteBuffer buf, BlockBuilder builder, ColumnSpec spec, byte[] nulls, int numRows) {
+        String type = spec.type();
+        Type trinoType = spec.trinoType();
+
+        switch (type) {
+            case "INTEGER", "DATE" -> {
+                for (int row = 0; row < numRows; row++) {
+                    int val = buf.getInt();
+                    if (isNull(nulls, row)) builder.appendNull();
+                    else trinoType.writeLong(builder, val);
+                }
+            }
+            case "BIGINT", "DECIMAL_SHORT" -> {
+                for (int row = 0; row < numRows; row++) {
+                    long val = buf.getLong();
+                    if (isNull(nulls, row)) builder.appendNull();
+                    else trinoType.writeLong(builder, val);
+                }
+            }
+            case "TIME" -> {
+                for (int row = 0; row < numRows; row++) {
+                    long val = buf.getLong();
+                    if (isNull(nulls, row)) builder.appendNull();
+                    else trinoType.writeLong(builder, adjustTime(val));
+                }
+            }
+            case "TIMESTAMP" -> {
+                for (int row = 0; row < numRows; row++) {
+                    long val = buf.getLong();
+                    if (isNull(nulls, row)) builder.appendNull();
+                    else trinoType.writeLong(builder, adjustTimestamp(val));
+                }
+            }
+            case "DOUBLE" -> {
+                for (int row = 0; row < numRows; row++) {
+                    double val = buf.getDouble();
+                    if (isNull(nulls, row)) builder.appendNull();
+                    else trinoType.writeDouble(builder, val);
+                }
+            }
+            case "DECIMAL_LONG" -> {
+                byte[] bytes = new byte[16];
+                for (int row = 0; row < numRows; row++) {
+                    buf.get(bytes);
+                    if (isNull(nulls, row)) {
+                        builder.appendNull();
+                    } else if (trinoType instanceof DecimalType decimalType) {
+                        decimalType.writeObject(builder, Int128.fromBigEndian(bytes));
+                    } else {
+                        builder.appendNull();
+                    }
+                }
+            }
+            default -> {
+                // VARCHAR, VARBINARY or fallback: int32 offsets (rows + 1) then
+                // concatenated bytes; VARBINARY bytes are raw, not UTF-8
+                Type sliceType = "VARBINARY".equals(type) ? VARBINARY : VARCHAR;
+                int[] offsets = new int[numRows + 1];
+                for (int i = 0; i <= numRows; i++) {
+                    offsets[i] = buf.getInt();
+                }
+                int dataStart = buf.position();
+                for (int row = 0; row < numRows; row++) {
+                    if (isNull(nulls, row)) {
+                        builder.appendNull();
+                        continue;
+                    }
+                    int len = offsets[row + 1] - offsets[row];
+                    io.airlift.slice.Slice slice;
+                    if (len == 0) {
+                        slice = Slices.EMPTY_SLICE;
+                    } else if (buf.hasArray()) {
+                        slice = Slices.wrappedBuffer(buf.array(), buf.arrayOffset() + dataStart + offsets[row], len);
+                    } else {
+                        byte[] strBytes = new byte[len];
+                        buf.position(dataStart + offsets[row]);
+                        buf.get(strBytes);
+                        slice = Slices.wrappedBuffer(strBytes);
+                    }
+                    if (spec.padTo() > 0) {
+                        slice = repadChar(slice, spec);
+                    }
+                    sliceType.writeSlice(builder, slice);
+                }
+                buf.position(dataStart + offsets[numRows]);
+            }
+        }
+    }
+
+    private static long adjustTime(long picos) {
+        long adjustedVal = picos + ((long) teradataTimezoneOffsetSeconds * 1_000_000_000_000L);
+        long picosPerDay = 24L * 60L * 60L * 1_000_000_000_000L;
+        if (adjustedVal < 0) {
+            adjustedVal += picosPerDay;
+        } else if (adjustedVal >= picosPerDay) {
+            adjustedVal %= picosPerDay;
+        }
+        return adjustedVal;
+    }
+
+    private static long adjustTimestamp(long micros) {
+        return micros + ((long) teradataTimezoneOffsetSeconds * 1_000_000L);
+    }
+
     private static void readAndAppendValue(ByteBuffer buf, BlockBuilder builder, ColumnSpec spec) {
         String type = spec.type;
         Type trinoType = spec.trinoType;
@@ -136,28 +332,15 @@ public final class DirectTrinoPageParser {
                 trinoType.writeLong(builder, val);
             }
             case "TIME" -> {
-                long val = buf.getLong();
                 // Apply timezone correction: TIME is in picoseconds since midnight
                 // Teradata sends local time values, we need to adjust by the timezone offset
-                // to get the correct representation when displayed
-                // offset is in seconds, TIME is in picoseconds (10^12)
-                long adjustedVal = val + ((long) teradataTimezoneOffsetSeconds * 1_000_000_000_000L);
-                // Handle wrap-around for TIME (stays within 0-24 hours)
-                long picosPerDay = 24L * 60L * 60L * 1_000_000_000_000L;
-                if (adjustedVal < 0) {
-                    adjustedVal += picosPerDay;
-                } else if (adjustedVal >= picosPerDay) {
-                    adjustedVal %= picosPerDay;
-                }
-                trinoType.writeLong(builder, adjustedVal);
+                long val = buf.getLong();
+                trinoType.writeLong(builder, adjustTime(val));
             }
             case "TIMESTAMP" -> {
-                long val = buf.getLong();
                 // Apply timezone correction: TIMESTAMP is in microseconds since epoch
-                // Teradata sends local time values, we need to adjust by the timezone offset
-                // offset is in seconds, TIMESTAMP is in microseconds (10^6)
-                long adjustedVal = val + ((long) teradataTimezoneOffsetSeconds * 1_000_000L);
-                trinoType.writeLong(builder, adjustedVal);
+                long val = buf.getLong();
+                trinoType.writeLong(builder, adjustTimestamp(val));
             }
             case "DOUBLE" -> {
                 double val = buf.getDouble();
@@ -179,23 +362,25 @@ public final class DirectTrinoPageParser {
                 }
             }
             default -> {
-                // VARCHAR or Fallback
+                // VARCHAR, VARBINARY or fallback: [uint16 length][bytes]
+                Type sliceType = "VARBINARY".equals(type) ? VARBINARY : VARCHAR;
                 int len = buf.getShort() & 0xFFFF;
+                io.airlift.slice.Slice slice;
                 if (len == 0) {
-                    VARCHAR.writeSlice(builder, io.airlift.slice.Slices.EMPTY_SLICE);
-                    return;
-                }
-
-                if (buf.hasArray()) {
+                    slice = io.airlift.slice.Slices.EMPTY_SLICE;
+                } else if (buf.hasArray()) {
                     // ZERO-ALLOCATION: Use Slice view of the underlying buffer array
-                    io.airlift.slice.Slice slice = io.airlift.slice.Slices.wrappedBuffer(buf.array(), buf.arrayOffset() + buf.position(), len);
-                    VARCHAR.writeSlice(builder, slice);
+                    slice = io.airlift.slice.Slices.wrappedBuffer(buf.array(), buf.arrayOffset() + buf.position(), len);
                     buf.position(buf.position() + len);
                 } else {
                     byte[] strBytes = new byte[len];
                     buf.get(strBytes);
-                    VARCHAR.writeSlice(builder, io.airlift.slice.Slices.wrappedBuffer(strBytes));
+                    slice = io.airlift.slice.Slices.wrappedBuffer(strBytes);
+                }
+                if (spec.padTo > 0) {
+                    slice = repadChar(slice, spec);
                 }
+                sliceType.writeSlice(builder, slice);
             }
         }
     }
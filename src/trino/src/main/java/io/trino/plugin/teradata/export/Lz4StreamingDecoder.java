@@ -0,0 +1,105 @@
+package io.trino.plugin.teradata.export;
+
+/**
+ * LZ4 block decoder that keeps the previous 64KB of decompressed output as a
+ * dictionary, matching LZ4_compress_fast_continue/LZ4_saveDict on the AMP side.
+ *
+ * aircompressor's Lz4Decompressor cannot resolve matches that reach back
+ * before the start of the current block, so streaming-mode batches
+ * (compression type 4) are decoded here instead. Batches decode into a
+ * persistent window buffer directly after the retained dictionary prefix;
+ * callers read the decompressed payload from {@link #buffer()} starting at
+ * {@link #dataOffset()}. One instance per socket connection - batches must be
+ * fed in wire order.
+ */
+final class Lz4StreamingDecoder {
+    private static final int DICT_SIZE = 64 * 1024;
+
+    private byte[] window;
+    private int dataStart;
+    private int dataLen;
+
+    Lz4StreamingDecoder(int maxDecompressedBatch) {
+        this.window = new byte[DICT_SIZE + maxDecompressedBatch];
+    }
+
+    byte[] buffer() {
+        return window;
+    }
+
+    int dataOffset() {
+        return dataStart;
+    }
+
+    /**
+     * Decompress one batch, using the tail of previously decompressed data as
+     * the dictionary. Returns the decompressed length; the payload is at
+     * buffer()[dataOffset() .. dataOffset() + length).
+     */
+    int decompress(byte[] src, int srcOffset, int srcLength) {
+        // Slide the retained dictionary to the front before reusing the window.
+        // This must happen here (not after the previous decode) so the caller
+        // could still parse the previous payload in place.
+        int total = dataStart + dataLen;
+        int keep = Math.min(DICT_SIZE, total);
+        if (total > keep) {
+            System.arraycopy(window, total - keep, window, 0, keep);
+        }
+        dataStart = keep;
+
+        dataLen = decodeBlock(src, srcOffset, srcLength, window, dataStart);
+        return dataLen;
+    }
+
+    /**
+     * Plain LZ4 block decode. Matches may reference bytes before dstOffset
+     * (the dictionary prefix), which is the whole point of this class.
+     */
+    private static int decodeBlock(byte[] src, int srcOffset, int srcLength, byte[] dst, int dstOffset) {
+        int sp = srcOffset;
+        int srcEnd = srcOffset + srcLength;
+        int dp = dstOffset;
+
+        while (sp < srcEnd) {
+            int token = src[sp++] & 0xFF;
+
+            int literalLength = token >>> 4;
+            if (literalLength == 15) {
+                int b;
+                do {
+                    b = src[sp++] & 0xFF;
+                    literalLength += b;
+                } while (b == 255);
+            }
+            System.arraycopy(src, sp, dst, dp, literalLength);
+            sp += literalLength;
+            dp += literalLength;
+
+            if (sp >= srcEnd) {
+                break; // last sequence has no match part
+            }
+
+            int offset = (src[sp] & 0xFF) | ((src[sp + 1] & 0xFF) << 8);
+            sp += 2;
+            int matchLength = token & 0xF;
+            if (matchLength == 15) {
+                int b;
+                do {
+                    b = src[sp++] & 0xFF;
+                    matchLength += b;
+                } while (b == 255);
+            }
+            matchLength += 4;
+            int ref = dp - offset;
+            if (ref < 0) {
+                throw new IllegalStateException("LZ4 match offset " + offset + " reaches before dictionary start");
+            }
+            // Byte-wise copy: matches may overlap their own output
+            for (int i = 0; i < matchLength; i++) {
+                dst[dp + i] = dst[ref + i];
+            }
+            dp += matchLength;
+        }
+        return dp - dstOffset;
+    }
+}
@@ -34,6 +34,13 @@ public final class PerformanceProfiler {
         public final AtomicLong networkWaitCount = new AtomicLong(0);
         public final AtomicLong queueFullWaitCount = new AtomicLong(0);
 
+        // AMP-side phase timings aggregated from UDF status rows (milliseconds)
+        public final AtomicLong ampReadMillis = new AtomicLong(0);
+        public final AtomicLong ampSerializeMillis = new AtomicLong(0);
+        public final AtomicLong ampCompressMillis = new AtomicLong(0);
+        public final AtomicLong ampSendMillis = new AtomicLong(0);
+        public final AtomicLong ampStatusCount = new AtomicLong(0);
+
         // First/last batch timestamps for throughput calculation
         public volatile long firstBatchTimeMs = 0;
         public volatile long lastBatchTimeMs = 0;
@@ -100,6 +107,61 @@ public final class PerformanceProfiler {
         }
     }
 
+    /**
+     * Parse the per-phase timing blob the UDF appends to its status VARCHAR
+     * ('t:{"read_ms":N,"ser_ms":N,"comp_ms":N,"send_ms":N}') and fold it into
+     * the query profile. One status row arrives per AMP; the summed values are
+     * cumulative CPU time across all AMPs, not wall time. Malformed or
+     * pre-upgrade status messages are ignored.
+     */
+    public static void recordAmpStatus(String queryId, String statusMessage) {
+        QueryProfile p = get(queryId);
+        if (p == null || statusMessage == null) {
+            return;
+        }
+        int start = statusMessage.indexOf("t:{");
+        if (start < 0) {
+            return;
+        }
+        int end = statusMessage.indexOf('}', start);
+        if (end < 0) {
+            return;
+        }
+        String blob = statusMessage.substring(start + 3, end);
+        long read = extractAmpMillis(blob, "read_ms");
+        long ser = extractAmpMillis(blob, "ser_ms");
+        long comp = extractAmpMillis(blob, "comp_ms");
+        long send = extractAmpMillis(blob, "send_ms");
+        if (read < 0 || ser < 0 || comp < 0 || send < 0) {
+            return;
+        }
+        p.ampReadMillis.addAndGet(read);
+        p.ampSerializeMillis.addAndGet(ser);
+        p.ampCompressMillis.addAndGet(comp);
+        p.ampSendMillis.addAndGet(send);
+        p.ampStatusCount.incrementAndGet();
+    }
+
+    private static long extractAmpMillis(String blob, String key) {
+        int idx = blob.indexOf("\"" + key + "\":");
+        if (idx < 0) {
+            return -1;
+        }
+        int pos = idx + key.length() + 3;
+        int endPos = pos;
+        while (endPos < blob.length() && (Character.isDigit(blob.charAt(endPos)) || blob.charAt(endPos) == '-')) {
+            endPos++;
+        }
+        if (endPos == pos) {
+            return -1;
+        }
+        try {
+            return Long.parseLong(blob.substring(pos, endPos));
+        } catch (NumberFormatException e) {
+            return -1;
+        }
+    }
+
 
 
     /**
@@ -172,7 +234,17 @@ public final class PerformanceProfiler {
         sb.append(String.format("║   Queue Full Waits:   %,10d    (producer blocked by slow consumer)     ║\n", p.queueFullWaitCount.get()));
         sb.append(String.format("║   Empty Queue Waits:  %,10d    (consumer waiting for network data)     ║\n", p.networkWaitCount.get()));
         sb.append("╠══════════════════════════════════════════════════════════════════════════════╣\n");
-        
+
+        if (p.ampStatusCount.get() > 0) {
+            sb.append("║ AMP-SIDE PHASES (summed across AMPs)         Time (ms)                       ║\n");
+            sb.append(String.format("║   AMPs Reporting:     %,10d                                            ║\n", p.ampStatusCount.get()));
+            sb.append(String.format("║   FNC_TblOpRead:                          %,10d                        ║\n", p.ampReadMillis.get()));
+            sb.append(String.format("║   Serialization:                          %,10d                        ║\n", p.ampSerializeMillis.get()));
+            sb.append(String.format("║   Compression:                            %,10d                        ║\n", p.ampCompressMillis.get()));
+            sb.append(String.format("║   Socket Send:                            %,10d                        ║\n", p.ampSendMillis.get()));
+            sb.append("╠══════════════════════════════════════════════════════════════════════════════╣\n");
+        }
+
         // Bottleneck analysis
         String bottleneck = "Unknown";
         String recommendation = "";
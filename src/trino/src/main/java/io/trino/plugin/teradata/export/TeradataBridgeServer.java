@@ -29,15 +29,33 @@ public class TeradataBridgeServer implements AutoCloseable {
     
     // Magic number for control messages
     public static final int CONTROL_MAGIC = 0xFEEDFACE;
+
+    // Credit-based flow control: the AMP requests it by setting this flag bit
+    // on the batch-format word, we grant a window of batch credits and return
+    // one each time a batch has been pushed into the DataBufferRegistry (which
+    // blocks while the consumer is behind, so credits track real drain rate).
+    public static final int CREDIT_MAGIC = 0xCAFEC0DE;
+    private static final int BATCH_FORMAT_CREDIT_FLAG = 0x40;
+    private static final int BATCH_FORMAT_KEEPALIVE_FLAG = 0x20;
+    public static final int ACK_MAGIC = 0xACC0ACC0;
+    private static final int BATCH_FORMAT_RESUME_FLAG = 0x10;
+    private static final int BATCH_FORMAT_ZONEMAP_FLAG = 0x08;
+    // CHARTRIM: CHAR values arrive with trailing blanks stripped; the schema
+    // JSON carries a per-column "padTo" and the parser restores the padding
+    private static final int BATCH_FORMAT_CHARTRIM_FLAG = 0x04;
+    private static final int ACK_INTERVAL = 8;
+    private static final int CREDIT_WINDOW = 8;
     
     // Thread pool limits - now controlled by config with defaults
     private static final int CORE_POOL_SIZE = 10;
     
     private final int port;
+    private final String unixSocketPath;
     private final int socketReceiveBufferSize;
     private final int inputBufferSize;
     private final ExecutorService executor;
     private ServerSocket serverSocket;
+    private java.nio.channels.ServerSocketChannel unixServerChannel;
     private final TrinoExportConfig config;
     private volatile boolean running = true;
 
@@ -45,6 +63,7 @@ public class TeradataBridgeServer implements AutoCloseable {
     public TeradataBridgeServer(TrinoExportConfig config) {
         this.config = config;
         this.port = config.getBridgePort();
+        this.unixSocketPath = config.getBridgeUnixSocketPath();
         this.socketReceiveBufferSize = config.getSocketReceiveBufferSize();
         this.inputBufferSize = config.getInputBufferSize();
         
@@ -71,6 +90,9 @@ public class TeradataBridgeServer implements AutoCloseable {
     @PostConstruct
     public void start() {
         executor.submit(this::runServer);
+        if (unixSocketPath != null && !unixSocketPath.isEmpty()) {
+            executor.submit(this::runUnixServer);
+        }
         log.info("Teradata Bridge Server starting on port %d", port);
     }
 
@@ -97,23 +119,139 @@ public class TeradataBridgeServer implements AutoCloseable {
         }
     }
 
+    /**
+     * Accept loop for the optional AF_UNIX listener. A bridge JVM runs on
+     * every Teradata node; AMPs configured with a unix:/path host connect
+     * here instead of loopback TCP, skipping TCP framing and checksums for
+     * node-local transfers. Each accepted channel is wrapped in a Socket
+     * adapter so the query protocol, credit/ack writers and the dynamic
+     * filter push in DataBufferRegistry work unchanged.
+     */
+    private void runUnixServer() {
+        java.nio.file.Path path = java.nio.file.Path.of(unixSocketPath);
+        try {
+            java.nio.file.Files.deleteIfExists(path);  // stale socket from a previous run
+            unixServerChannel = java.nio.channels.ServerSocketChannel.open(java.net.StandardProtocolFamily.UNIX);
+            unixServerChannel.bind(java.net.UnixDomainSocketAddress.of(path));
+            log.info("Teradata Bridge Server listening on unix socket %s", unixSocketPath);
+
+            while (running) {
+                try {
+                    java.nio.channels.SocketChannel channel = unixServerChannel.accept();
+                    log.info("Connection on unix socket %s", unixSocketPath);
+                    executor.submit(() -> handleClient(new UnixSocketAdapter(channel)));
+                } catch (IOException e) {
+                    if (running) {
+                        log.warn("Error accepting unix socket connection: %s", e.getMessage());
+                    }
+                }
+            }
+        } catch (IOException e) {
+            log.error(e, "Failed to start bridge server on unix socket %s", unixSocketPath);
+        }
+    }
+
+    /**
+     * Presents an AF_UNIX SocketChannel as a java.net.Socket. Only the
+     * surface the bridge actually touches is implemented: streams, remote
+     * address for logs, close, and identity as the monitor that serializes
+     * credit/ack/filter writes. TCP-only tuning calls are no-ops.
+     */
+    private static class UnixSocketAdapter extends Socket {
+        private final java.nio.channels.SocketChannel channel;
+        private final InputStream in;
+        private final OutputStream out;
+
+        UnixSocketAdapter(java.nio.channels.SocketChannel channel) {
+            this.channel = channel;
+            this.in = java.nio.channels.Channels.newInputStream(channel);
+            this.out = java.nio.channels.Channels.newOutputStream(channel);
+        }
+
+        @Override
+        public InputStream getInputStream() {
+            return in;
+        }
+
+        @Override
+        public OutputStream getOutputStream() {
+            return out;
+        }
+
+        @Override
+        public java.net.SocketAddress getRemoteSocketAddress() {
+            try {
+                return channel.getRemoteAddress();
+            } catch (IOException e) {
+                return null;
+            }
+        }
+
+        @Override
+        public boolean isConnected() {
+            return channel.isConnected();
+        }
+
+        @Override
+        public void setTcpNoDelay(boolean on) {
+            // No Nagle on AF_UNIX
+        }
+
+        @Override
+        public void setReceiveBufferSize(int size) {
+            // Kernel defaults are adequate for a node-local stream
+        }
+
+        @Override
+        public synchronized void close() throws IOException {
+            channel.close();
+        }
+    }
+
     private void handleClient(Socket socket) {
+        try (DataInputStream in = new DataInputStream(new BufferedInputStream(socket.getInputStream(), inputBufferSize));
+             DataOutputStream out = new DataOutputStream(socket.getOutputStream())) {
+            // Keep-alive sessions run several queries back to back on the
+            // same connection; each iteration handles one query exchange.
+            while (processQuery(socket, in, out)) { }
+        } catch (IOException e) {
+            log.warn("Error on bridge connection from %s: %s", socket.getRemoteSocketAddress(), e.getMessage());
+        } finally {
+            try {
+                socket.close();
+            } catch (IOException ignored) {}
+        }
+    }
+
+    /**
+     * Handle one full query exchange (handshake, batches, EOS ack) on the
+     * connection. Returns true when the AMP requested keep-alive and the
+     * query ended cleanly, i.e. the caller should wait for the next
+     * handshake on the same socket.
+     */
+    private boolean processQuery(Socket socket, DataInputStream in, DataOutputStream out) {
         String queryId = "unknown";
         boolean incremented = false;
+        int stripeCount = 1;
+        int stripeGroup = 0;
         long compressedBytes = 0;
         long decompressedBytes = 0;
         int totalRows = 0;
+        boolean keepAlive = false;
         java.util.zip.Inflater inflater = null;  // Declare outside try for proper cleanup
-            
-        try (DataInputStream in = new DataInputStream(new BufferedInputStream(socket.getInputStream(), inputBufferSize));
-             DataOutputStream out = new DataOutputStream(socket.getOutputStream())) {
-            
+
+        try {
             // 1. Mandatory Dynamic Token Validation
             // Protocol: [tokenLen (int)][token (string)][queryIdLen/Magic (int)][queryId (string)]...
-            int tokenLen = in.readInt();
+            int tokenLen;
+            try {
+                tokenLen = in.readInt();
+            } catch (EOFException e) {
+                return false;  // keep-alive peer closed the idle session
+            }
             if (tokenLen <= 0 || tokenLen > 1024) {
                 log.error("Invalid token length: %d from %s", tokenLen, socket.getRemoteSocketAddress());
-                return;
+                return false;
             }
             byte[] tokenBytes = new byte[tokenLen];
             in.readFully(tokenBytes);
@@ -124,13 +262,13 @@ public class TeradataBridgeServer implements AutoCloseable {
             
             if (lenOrMagic == CONTROL_MAGIC) {
                 handleControlMessage(in, out, receivedToken);
-                return;
+                return false;
             }
             
             // It's a normal Query ID - Validate length to prevent NegativeArraySizeException
             if (lenOrMagic <= 0 || lenOrMagic > 1024) {
                 log.error("Invalid Query ID length or Magic Number: %d from %s", lenOrMagic, socket.getRemoteSocketAddress());
-                return;
+                return false;
             }
             byte[] queryIdBytes = new byte[lenOrMagic];
             in.readFully(queryIdBytes);
@@ -141,7 +279,7 @@ public class TeradataBridgeServer implements AutoCloseable {
                 log.error("Unauthorized: Invalid dynamic token for query %s from %s", queryId, socket.getRemoteSocketAddress());
                 out.write("ERROR: UNAUTHORIZED".getBytes(StandardCharsets.UTF_8));
                 out.flush();
-                return;
+                return false;
             }
 
             log.info("Receiving data for authenticated query: %s", queryId);
@@ -149,16 +287,51 @@ public class TeradataBridgeServer implements AutoCloseable {
             // Register this connection FIRST (before any data processing)
             DataBufferRegistry.incrementConnections(queryId);
             incremented = true;
+
+            // Make the socket reachable for mid-export dynamic filter pushes
+            DataBufferRegistry.registerDataSocket(queryId, socket);
             
             // Read Compression Type
             int compressionType = in.readInt();
-            String algo = (compressionType == 2) ? "LZ4" : (compressionType == 1) ? "ZLIB" : "NONE";
+            String algo = (compressionType == 5) ? "ADAPTIVE" : (compressionType == 4) ? "LZ4_STREAM" : (compressionType == 3) ? "ZSTD" : (compressionType == 2) ? "LZ4" : (compressionType == 1) ? "ZLIB" : "NONE";
             if (compressionType != 0) {
                 log.info("AUTHENTICATION SUCCESS: Query %s using compression %s", queryId, algo);
             } else {
                 log.info("AUTHENTICATION SUCCESS: Query %s with compression DISABLED", queryId);
             }
 
+            // Read Batch Format (1 = row-interleaved, 2 = columnar), plus the
+            // optional credit-flow, keep-alive, resume and zone-map flags
+            int batchFormat = in.readInt();
+            boolean creditFlow = (batchFormat & BATCH_FORMAT_CREDIT_FLAG) != 0;
+            keepAlive = (batchFormat & BATCH_FORMAT_KEEPALIVE_FLAG) != 0;
+            boolean resumeMode = (batchFormat & BATCH_FORMAT_RESUME_FLAG) != 0;
+            boolean zoneMapMode = (batchFormat & BATCH_FORMAT_ZONEMAP_FLAG) != 0;
+            batchFormat &= ~(BATCH_FORMAT_CREDIT_FLAG | BATCH_FORMAT_KEEPALIVE_FLAG
+                    | BATCH_FORMAT_RESUME_FLAG | BATCH_FORMAT_ZONEMAP_FLAG
+                    | BATCH_FORMAT_CHARTRIM_FLAG);
+            if (batchFormat != 1 && batchFormat != 2) {
+                log.error("Unknown batch format %d for query %s", batchFormat, queryId);
+                return false;
+            }
+            log.info("Query %s using batch format %s", queryId, batchFormat == 2 ? "COLUMNAR" : "ROW");
+
+            // Read Striping Info: sockets per AMP and this connection's group
+            // id. With more than one stripe, each data frame carries a
+            // sequence number after its length. The group id is unique per
+            // connection - an AMP's stripes may land on different worker
+            // JVMs, so each socket numbers and re-orders its own frames.
+            stripeCount = in.readInt();
+            stripeGroup = in.readInt();
+            if (stripeCount < 1 || stripeCount > 64) {
+                log.error("Invalid stripe count %d for query %s", stripeCount, queryId);
+                return false;
+            }
+            if (stripeCount > 1) {
+                DataBufferRegistry.registerStripeGroup(queryId, stripeGroup);
+                log.info("Query %s striping: connection group %d (%d sockets on the AMP)", queryId, stripeGroup, stripeCount);
+            }
+
             // Read Schema JSON (for verification and name matching)
             int schemaLen = in.readInt();
             byte[] schemaBytes = new byte[schemaLen];
@@ -181,14 +354,26 @@ public class TeradataBridgeServer implements AutoCloseable {
             
             // Initialize profiler
             PerformanceProfiler.getOrCreate(queryId);
+
+            // Handshake complete: grant the AMP its initial send window
+            if (creditFlow) {
+                sendCredit(socket, out, CREDIT_WINDOW);
+                log.info("Query %s credit flow enabled, window=%d", queryId, CREDIT_WINDOW);
+            }
             
             // Synchronous processing - create decompression buffer with enough space for max Teradata batch (16MB)
             // Using 32MB to be absolutely safe and avoid reallocations
             inflater = (compressionType == 1) ? new java.util.zip.Inflater() : null;
-            io.airlift.compress.lz4.Lz4Decompressor lz4Decompressor = (compressionType == 2) ? new io.airlift.compress.lz4.Lz4Decompressor() : null;
-            byte[] decompressionBuffer = (compressionType != 0) ? new byte[32 * 1024 * 1024] : null;
+            // ADAPTIVE (5) batches carry a per-batch codec byte of NONE or LZ4
+            io.airlift.compress.lz4.Lz4Decompressor lz4Decompressor = (compressionType == 2 || compressionType == 5) ? new io.airlift.compress.lz4.Lz4Decompressor() : null;
+            io.airlift.compress.zstd.ZstdDecompressor zstdDecompressor = (compressionType == 3) ? new io.airlift.compress.zstd.ZstdDecompressor() : null;
+            // Streaming LZ4 keeps a 64KB cross-batch dictionary; per-connection, wire order
+            Lz4StreamingDecoder streamDecoder = (compressionType == 4) ? new Lz4StreamingDecoder(32 * 1024 * 1024) : null;
+            byte[] decompressionBuffer = (compressionType == 1 || compressionType == 2 || compressionType == 3 || compressionType == 5) ? new byte[32 * 1024 * 1024] : null;
 
             // Read and process batches synchronously until end of stream
+            int batchesSinceAck = 0;
+            long batchesSkipped = 0;
             while (true) {
                 // Profile: Network Read
                 long netStart = System.nanoTime();
@@ -198,17 +383,85 @@ public class TeradataBridgeServer implements AutoCloseable {
                     break;
                 }
                 
+                // Adaptive mode: the AMP picks none vs. LZ4 per batch
+                int batchCodec = compressionType;
+                if (compressionType == 5) {
+                    batchCodec = in.readByte() & 0xFF;
+                }
+
+                // Striped and resume-mode frames carry the AMP's batch sequence number
+                int batchSeq = (stripeCount > 1 || resumeMode) ? in.readInt() : -1;
+
+                // Zone-map frames carry [n]{[col][min][max]} between sequence
+                // and payload, uncompressed, so pruning can happen before any
+                // decompression CPU is spent on the batch
+                long[][] zoneMap = null;
+                if (zoneMapMode) {
+                    int zoneCount = in.readUnsignedByte();
+                    if (zoneCount > 0) {
+                        zoneMap = new long[zoneCount][3];
+                        for (int z = 0; z < zoneCount; z++) {
+                            zoneMap[z][0] = in.readUnsignedByte();
+                            zoneMap[z][1] = in.readLong();
+                            zoneMap[z][2] = in.readLong();
+                        }
+                    }
+                }
+
                 byte[] batchData = new byte[batchLen];
                 in.readFully(batchData);
                 long netEnd = System.nanoTime();
                 PerformanceProfiler.recordNetworkRead(queryId, netEnd - netStart, batchLen);
                 compressedBytes += batchLen;
-                
+
+                // A replayed batch after an AMP reconnect may already be
+                // downstream - dedup by sequence before spending any CPU on it
+                if (resumeMode && !DataBufferRegistry.markSequence(queryId, stripeGroup, batchSeq)) {
+                    log.info("Query %s: dropping replayed batch seq %d", queryId, batchSeq);
+                    if (creditFlow) {
+                        sendCredit(socket, out, 1);
+                    }
+                    if (++batchesSinceAck >= ACK_INTERVAL) {
+                        sendAck(socket, out, batchSeq);
+                        batchesSinceAck = 0;
+                    }
+                    continue;
+                }
+
+                // Zone-map pruning: when a tracked column's [min,max] is
+                // disjoint from the query's value domain, no row of this
+                // batch can survive the filter - drop it without
+                // decompressing or parsing. Striped groups still advance
+                // their reorder sequence past the hole.
+                if (zoneMap != null && DataBufferRegistry.zoneMapExcludes(queryId, zoneMap)) {
+                    batchesSkipped++;
+                    if (stripeCount > 1) {
+                        DataBufferRegistry.skipSequenceOrdered(queryId, stripeGroup, batchSeq);
+                    }
+                    if (creditFlow) {
+                        sendCredit(socket, out, 1);
+                    }
+                    if (resumeMode && ++batchesSinceAck >= ACK_INTERVAL) {
+                        sendAck(socket, out, batchSeq);
+                        batchesSinceAck = 0;
+                    }
+                    continue;
+                }
+
                 // SYNCHRONOUS: Decompress immediately in this thread
                 byte[] decompressed;
                 int decompressedLen;
-                
-                if (compressionType == 1) { /* ZLIB */
+                int payloadOffset = 0;
+
+                if (batchCodec == 4) { /* LZ4 streaming */
+                    long decompStart = System.nanoTime();
+                    decompressedLen = streamDecoder.decompress(batchData, 0, batchLen);
+                    long decompEnd = System.nanoTime();
+                    PerformanceProfiler.recordDecompression(queryId, decompEnd - decompStart, decompressedLen);
+                    decompressed = streamDecoder.buffer();
+                    payloadOffset = streamDecoder.dataOffset();
+                    decompressedBytes += decompressedLen;
+                } else if (batchCodec == 1) { /* ZLIB */
                     long decompStart = System.nanoTime();
                     inflater.reset();
                     inflater.setInput(batchData, 0, batchLen);
@@ -224,7 +477,7 @@ public class TeradataBridgeServer implements AutoCloseable {
                     PerformanceProfiler.recordDecompression(queryId, decompEnd - decompStart, decompressedLen);
                     decompressed = decompressionBuffer;
                     decompressedBytes += decompressedLen;
-                } else if (compressionType == 2) { /* LZ4 */
+                } else if (batchCodec == 2) { /* LZ4 */
                     long decompStart = System.nanoTime();
                     // Ensure buffer is large enough.
                     if (decompressionBuffer.length < 32 * 1024 * 1024) {
@@ -235,6 +488,16 @@ public class TeradataBridgeServer implements AutoCloseable {
                     PerformanceProfiler.recordDecompression(queryId, decompEnd - decompStart, decompressedLen);
                     decompressed = decompressionBuffer;
                     decompressedBytes += decompressedLen;
+                } else if (batchCodec == 3) { /* ZSTD */
+                    long decompStart = System.nanoTime();
+                    if (decompressionBuffer.length < 32 * 1024 * 1024) {
+                        decompressionBuffer = new byte[32 * 1024 * 1024];
+                    }
+                    decompressedLen = zstdDecompressor.decompress(batchData, 0, batchLen, decompressionBuffer, 0, decompressionBuffer.length);
+                    long decompEnd = System.nanoTime();
+                    PerformanceProfiler.recordDecompression(queryId, decompEnd - decompStart, decompressedLen);
+                    decompressed = decompressionBuffer;
+                    decompressedBytes += decompressedLen;
                 } else {
                     decompressed = batchData;
                     decompressedLen = batchLen;
@@ -243,7 +506,9 @@ public class TeradataBridgeServer implements AutoCloseable {
 
                 // SYNCHRONOUS: Parse directly to Trino Page in this thread
                 long parseStart = System.nanoTime();
-                io.trino.spi.Page page = DirectTrinoPageParser.parseDirectToPage(decompressed, decompressedLen, columns);
+                io.trino.spi.Page page = (batchFormat == 2)
+                        ? DirectTrinoPageParser.parseColumnarToPage(decompressed, payloadOffset, decompressedLen, columns)
+                        : DirectTrinoPageParser.parseDirectToPage(decompressed, payloadOffset, decompressedLen, columns);
                 long parseEnd = System.nanoTime();
                 
                 if (page != null && page.getPositionCount() > 0) {
@@ -253,10 +518,26 @@ public class TeradataBridgeServer implements AutoCloseable {
                     // SYNCHRONOUS: Push to buffer in this thread
                     // Data is in buffer BEFORE we move to next batch or decrement connection
                     long pushStart = System.nanoTime();
-                    DataBufferRegistry.pushData(queryId, page);
+                    if (stripeCount > 1) {
+                        DataBufferRegistry.pushDataOrdered(queryId, stripeGroup, batchSeq, page);
+                    } else {
+                        DataBufferRegistry.pushData(queryId, page);
+                    }
                     long pushEnd = System.nanoTime();
                     PerformanceProfiler.recordQueuePush(queryId, pushEnd - pushStart, (pushEnd - pushStart) > 1_000_000);
                 }
+
+                // The batch is downstream (the push above blocks while the
+                // consumer is behind) - return its credit to the AMP
+                if (creditFlow) {
+                    sendCredit(socket, out, 1);
+                }
+                // ... and periodically checkpoint it so the AMP can trim
+                // its replay window
+                if (resumeMode && ++batchesSinceAck >= ACK_INTERVAL) {
+                    sendAck(socket, out, batchSeq);
+                    batchesSinceAck = 0;
+                }
             }
             
             // All data is now in the buffer - safe to send acknowledgment
@@ -264,11 +545,19 @@ public class TeradataBridgeServer implements AutoCloseable {
             out.flush();
             
             double ratio = compressedBytes > 0 ? (double) decompressedBytes / compressedBytes : 1.0;
-            log.info("Successfully processed query %s: %d rows, %.2f MB compressed, %.2f MB decompressed (Ratio: %.2fx)", 
+            log.info("Successfully processed query %s: %d rows, %.2f MB compressed, %.2f MB decompressed (Ratio: %.2fx)",
                 queryId, totalRows, compressedBytes / (1024.0 * 1024.0), decompressedBytes / (1024.0 * 1024.0), ratio);
-            
+            if (batchesSkipped > 0) {
+                log.info("Query %s zone maps pruned %d batches before decompression", queryId, batchesSkipped);
+            }
+            if (keepAlive) {
+                log.info("Query %s keep-alive: holding connection from %s for reuse", queryId, socket.getRemoteSocketAddress());
+            }
+            return keepAlive;
+
         } catch (Exception e) {
             log.error(e, "Error handling client for query %s", queryId);
+            return false;  // stream state is unknown - never reuse after an error
         } finally {
             // CRITICAL: Release Inflater native memory to prevent native memory leak
             if (inflater != null) {
@@ -279,13 +568,42 @@ public class TeradataBridgeServer implements AutoCloseable {
                 }
             }
             
+            DataBufferRegistry.unregisterDataSocket(queryId, socket);
+            // Release this connection's stripe slot BEFORE decrementing, so any
+            // gap-stranded pages are flushed while the connection still counts
+            if (stripeCount > 1) {
+                DataBufferRegistry.closeStripeConnection(queryId, stripeGroup);
+            }
             // CRITICAL: Connection is only decremented AFTER all data is in the buffer
             if (incremented) {
                 DataBufferRegistry.decrementConnections(queryId);
             }
-            try {
-                socket.close();
-            } catch (IOException ignored) {}
+            // Socket is closed by handleClient once the session ends; a
+            // keep-alive session survives this query's cleanup.
+        }
+    }
+
+    /**
+     * Write a credit grant on the data socket's back channel. Synchronized on
+     * the socket because dynamic filter pushes share the same output stream.
+     */
+    /**
+     * Acknowledge all batches up to and including the given sequence on the
+     * back channel, letting the AMP release them from its replay window.
+     */
+    private static void sendAck(Socket socket, DataOutputStream out, int seq) throws IOException {
+        synchronized (socket) {
+            out.writeInt(ACK_MAGIC);
+            out.writeInt(seq);
+            out.flush();
+        }
+    }
+
+    private static void sendCredit(Socket socket, DataOutputStream out, int credits) throws IOException {
+        synchronized (socket) {
+            out.writeInt(CREDIT_MAGIC);
+            out.writeInt(credits);
+            out.flush();
         }
     }
 
@@ -313,6 +631,21 @@ public class TeradataBridgeServer implements AutoCloseable {
                 
                 log.info("Received Global EOS signal for query %s", queryId);
                 DataBufferRegistry.signalJdbcFinished(queryId);
+            } else if (command == 2) { // 2 = DYNAMIC_FILTER
+                int specLen = in.readInt();
+                if (specLen <= 0 || specLen > 65536) {
+                    log.error("Invalid dynamic filter length %d for query %s", specLen, queryId);
+                    return;
+                }
+                byte[] specBytes = new byte[specLen];
+                in.readFully(specBytes);
+                // Filters change what data the AMPs send, so require full validation
+                if (!DataBufferRegistry.validateDynamicToken(queryId, receivedToken)) {
+                    log.error("Unauthorized dynamic filter: Invalid dynamic token for query %s", queryId);
+                    return;
+                }
+                String filterSpec = new String(specBytes, StandardCharsets.UTF_8);
+                DataBufferRegistry.pushDynamicFilter(queryId, filterSpec);
             } else {
                 // For other control commands, require full token validation
                 if (!DataBufferRegistry.validateDynamicToken(queryId, receivedToken)) {
@@ -335,6 +668,12 @@ public class TeradataBridgeServer implements AutoCloseable {
         try {
             if (serverSocket != null) serverSocket.close();
         } catch (IOException ignored) {}
+        try {
+            if (unixServerChannel != null) {
+                unixServerChannel.close();
+                java.nio.file.Files.deleteIfExists(java.nio.file.Path.of(unixSocketPath));
+            }
+        } catch (IOException ignored) {}
         executor.shutdownNow();
         log.info("Teradata Bridge Server stopped");
     }
@@ -16,6 +16,7 @@ public class TrinoExportConfig {
     // === Network/Port Settings ===
     private int flightPort = 50051;
     private int bridgePort = 9999;
+    private String bridgeUnixSocketPath;  // AF_UNIX listener for co-located AMPs
     private String trinoAddress = "172.27.251.157";
     private String flightBindAddress = "0.0.0.0";
     private String workerAdvertisedAddresses;  // For NAT/multi-homed networks
@@ -141,6 +142,16 @@ public class TrinoExportConfig {
         return this;
     }
 
+    public String getBridgeUnixSocketPath() {
+        return bridgeUnixSocketPath;
+    }
+
+    @Config("teradata.export.bridge-unix-socket-path")
+    public TrinoExportConfig setBridgeUnixSocketPath(String bridgeUnixSocketPath) {
+        this.bridgeUnixSocketPath = bridgeUnixSocketPath;
+        return this;
+    }
+
     public String getTrinoAddress() {
         return trinoAddress;
     }
@@ -124,6 +124,18 @@ public class TrinoExportDynamicFilteringSplitSource implements ConnectorSplitSou
         }
 
         String whereClause = predicateParts.isEmpty() ? "" : " WHERE " + String.join(" AND ", predicateParts);
+
+        // If the dynamic filter is still narrowing after execution started,
+        // push the completed filter down to the AMPs mid-export: the UDF polls
+        // its data socket between batches and drops non-matching rows before
+        // serialization, instead of shipping the full table. Only safe when
+        // the inner SELECT exports the full column list - the spec addresses
+        // columns by stream position, which equals the table ordinal only then.
+        boolean fullColumnList = !tableHandle.hasAggregation()
+                && tableHandle.getProjectedColumns().map(List::isEmpty).orElse(true);
+        if (config.isEnableDynamicFiltering() && dynamicFilter != null && !dynamicFilter.isComplete() && fullColumnList) {
+            scheduleMidExportFilterPush();
+        }
         
         // For Top-N queries: use "TOP N" with ORDER BY (sorted result)
         // For plain LIMIT: use SAMPLE (random sampling, no sorting)
@@ -173,7 +185,15 @@ public class TrinoExportDynamicFilteringSplitSource implements ConnectorSplitSou
         try (Connection conn = getConnection();
              java.sql.Statement stmt = conn.createStatement();
              java.sql.ResultSet rs = stmt.executeQuery(teradataSql)) {
-            while (rs.next()) { }
+            while (rs.next()) {
+                // Column 7 is the UDF status VARCHAR; it carries the per-AMP
+                // phase timing blob the profiler aggregates.
+                try {
+                    PerformanceProfiler.recordAmpStatus(splitId, rs.getString(7));
+                } catch (Exception ignore) {
+                    // Older UDF builds emit fewer columns; timings are best-effort
+                }
+            }
             log.info("Teradata SQL execution finished successfully for query %s", splitId);
         } catch (Exception e) {
             log.error(e, "Error executing Teradata SQL for query %s", splitId);
@@ -187,6 +207,60 @@ public class TrinoExportDynamicFilteringSplitSource implements ConnectorSplitSou
         }
     }
 
+    private void scheduleMidExportFilterPush() {
+        if (closed.get()) return;
+        if (dynamicFilter.isComplete()) {
+            broadcastDynamicFilter();
+            return;
+        }
+        dynamicFilter.isBlocked().toCompletableFuture()
+                .thenRunAsync(this::scheduleMidExportFilterPush, executor);
+    }
+
+    private void broadcastDynamicFilter() {
+        TupleDomain<ColumnHandle> predicate = dynamicFilter.getCurrentPredicate();
+        if (predicate.isAll() || predicate.getDomains().isEmpty()) return;
+
+        List<String> specParts = new ArrayList<>();
+        for (java.util.Map.Entry<ColumnHandle, io.trino.spi.predicate.Domain> entry : predicate.getDomains().get().entrySet()) {
+            TrinoExportColumnHandle column = (TrinoExportColumnHandle) entry.getKey();
+            String spec = TrinoExportFilterUtils.domainToPredSpec(column.getOrdinal(), column.getType(), entry.getValue());
+            if (spec != null) specParts.add(spec);
+        }
+        if (specParts.isEmpty()) return;
+        String filterSpec = String.join(";", specParts);
+
+        // Same fan-out as the EOS broadcast: every bridge worker relays the
+        // filter to the data connections it is serving for this query.
+        String[] ips = targetIps.split(",");
+        for (String ipPort : ips) {
+            String target = ipPort.trim();
+            if (target.isEmpty()) continue;
+            try {
+                String[] parts = target.split(":");
+                try (Socket socket = new Socket(parts[0], Integer.parseInt(parts[1]));
+                     DataOutputStream out = new DataOutputStream(socket.getOutputStream())) {
+                    socket.setSoTimeout(5000);
+                    byte[] tokenBytes = dynamicToken.getBytes(StandardCharsets.UTF_8);
+                    out.writeInt(tokenBytes.length);
+                    out.write(tokenBytes);
+                    out.writeInt(TeradataBridgeServer.CONTROL_MAGIC);
+                    byte[] qidBytes = splitId.getBytes(StandardCharsets.UTF_8);
+                    out.writeInt(qidBytes.length);
+                    out.write(qidBytes);
+                    out.writeInt(2); // 2 = DYNAMIC_FILTER
+                    byte[] specBytes = filterSpec.getBytes(StandardCharsets.UTF_8);
+                    out.writeInt(specBytes.length);
+                    out.write(specBytes);
+                    out.flush();
+                }
+                log.info("Broadcast dynamic filter to worker %s for query %s: %s", target, splitId, filterSpec);
+            } catch (Exception e) {
+                log.warn("Failed to broadcast dynamic filter to worker %s: %s", target, e.getMessage());
+            }
+        }
+    }
+
     private void broadcastJdbcFinishedSignal(String dynamicToken) {
         if (targetIps == null || targetIps.isEmpty()) return;
         
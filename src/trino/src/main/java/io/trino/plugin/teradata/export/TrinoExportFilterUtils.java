@@ -137,6 +137,78 @@ public final class TrinoExportFilterUtils {
         return String.join(" AND ", parts);
     }
 
+    /**
+     * Convert a Domain into the compact predicate spec the UDF evaluates
+     * between batches ("col:OP[:value|:v1,v2,...]"). The C side compares the
+     * raw stored integer, so DATE values are re-encoded from epoch days to
+     * Teradata's (year-1900)*10000 + month*100 + day form. Returns null when
+     * the domain cannot be expressed (non-integer type, NULL-allowing
+     * domain - the AMP predicates reject NULLs, which would drop valid rows).
+     */
+    public static String domainToPredSpec(int columnIndex, Type type, Domain domain) {
+        if (domain.isAll() || domain.isNone() || domain.isNullAllowed()) {
+            return null;
+        }
+
+        ValueSet valueSet = domain.getValues();
+        if (!(valueSet instanceof SortedRangeSet rangeSet)) {
+            return null;
+        }
+
+        // Discrete set: EQ for one value, IN-list for a small set
+        if (rangeSet.getOrderedRanges().stream().allMatch(Range::isSingleValue)) {
+            List<Long> values = new ArrayList<>();
+            for (Range range : rangeSet.getOrderedRanges()) {
+                Long raw = valueToRawLong(range.getSingleValue(), type);
+                if (raw == null || values.size() >= 64) {
+                    return null;
+                }
+                values.add(raw);
+            }
+            if (values.isEmpty()) {
+                return null;
+            }
+            if (values.size() == 1) {
+                return columnIndex + ":EQ:" + values.get(0);
+            }
+            return columnIndex + ":IN:" + values.stream().map(String::valueOf).collect(Collectors.joining(","));
+        }
+
+        // Otherwise ship the enclosing min/max; a superset filter is always safe
+        Range span = rangeSet.getSpan();
+        List<String> parts = new ArrayList<>();
+        if (!span.isLowUnbounded()) {
+            Long low = valueToRawLong(span.getLowBoundedValue(), type);
+            if (low == null) {
+                return null;
+            }
+            parts.add(columnIndex + (span.isLowInclusive() ? ":GE:" : ":GT:") + low);
+        }
+        if (!span.isHighUnbounded()) {
+            Long high = valueToRawLong(span.getHighBoundedValue(), type);
+            if (high == null) {
+                return null;
+            }
+            parts.add(columnIndex + (span.isHighInclusive() ? ":LE:" : ":LT:") + high);
+        }
+        return parts.isEmpty() ? null : String.join(";", parts);
+    }
+
+    private static Long valueToRawLong(Object value, Type type) {
+        if (value == null) {
+            return null;
+        }
+        if (type == IntegerType.INTEGER || type == BigintType.BIGINT ||
+            type == SmallintType.SMALLINT || type == TinyintType.TINYINT) {
+            return ((Number) value).longValue();
+        }
+        if (type instanceof DateType) {
+            LocalDate date = LocalDate.ofEpochDay((Long) value);
+            return (long) ((date.getYear() - 1900) * 10000 + date.getMonthValue() * 100 + date.getDayOfMonth());
+        }
+        return null;
+    }
+
     private static String formatValue(Object value, Type type) {
         if (value == null) {
             return "NULL";
@@ -608,6 +608,12 @@ public class TrinoExportMetadata implements io.trino.spi.connector.ConnectorMeta
             case java.sql.Types.VARCHAR:
             case java.sql.Types.CHAR:
             case java.sql.Types.LONGVARCHAR: return io.trino.spi.type.VarcharType.VARCHAR;
+
+            // Teradata BYTE/VARBYTE: exported as raw length-prefixed binary
+            case java.sql.Types.BINARY:
+            case java.sql.Types.VARBINARY:
+            case java.sql.Types.LONGVARBINARY: return io.trino.spi.type.VarbinaryType.VARBINARY;
+
             default: return io.trino.spi.type.VarcharType.VARCHAR;
         }
     }